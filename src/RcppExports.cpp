@@ -11,21 +11,173 @@ Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
 // png_to_escpos_raster
-std::string png_to_escpos_raster(std::string png_file, std::string raster_path, bool color);
-RcppExport SEXP _escpos_png_to_escpos_raster(SEXP png_fileSEXP, SEXP raster_pathSEXP, SEXP colorSEXP) {
+Rcpp::CharacterVector png_to_escpos_raster(Rcpp::CharacterVector png_files, Rcpp::CharacterVector raster_paths, bool color, std::string dither, int threads, int workers, bool compress, std::string raster, std::string equalise, double gamma, double contrast, int brightness, int background, int width, int rotate, Rcpp::IntegerVector printer);
+RcppExport SEXP _escpos_png_to_escpos_raster(SEXP png_filesSEXP, SEXP raster_pathsSEXP, SEXP colorSEXP, SEXP ditherSEXP, SEXP threadsSEXP, SEXP workersSEXP, SEXP compressSEXP, SEXP rasterSEXP, SEXP equaliseSEXP, SEXP gammaSEXP, SEXP contrastSEXP, SEXP brightnessSEXP, SEXP backgroundSEXP, SEXP widthSEXP, SEXP rotateSEXP, SEXP printerSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< std::string >::type png_file(png_fileSEXP);
-    Rcpp::traits::input_parameter< std::string >::type raster_path(raster_pathSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type png_files(png_filesSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector >::type raster_paths(raster_pathsSEXP);
     Rcpp::traits::input_parameter< bool >::type color(colorSEXP);
-    rcpp_result_gen = Rcpp::wrap(png_to_escpos_raster(png_file, raster_path, color));
+    Rcpp::traits::input_parameter< std::string >::type dither(ditherSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type workers(workersSEXP);
+    Rcpp::traits::input_parameter< bool >::type compress(compressSEXP);
+    Rcpp::traits::input_parameter< std::string >::type raster(rasterSEXP);
+    Rcpp::traits::input_parameter< std::string >::type equalise(equaliseSEXP);
+    Rcpp::traits::input_parameter< double >::type gamma(gammaSEXP);
+    Rcpp::traits::input_parameter< double >::type contrast(contrastSEXP);
+    Rcpp::traits::input_parameter< int >::type brightness(brightnessSEXP);
+    Rcpp::traits::input_parameter< int >::type background(backgroundSEXP);
+    Rcpp::traits::input_parameter< int >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< int >::type rotate(rotateSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type printer(printerSEXP);
+    rcpp_result_gen = Rcpp::wrap(png_to_escpos_raster(png_files, raster_paths, color, dither, threads, workers, compress, raster, equalise, gamma, contrast, brightness, background, width, rotate, printer));
+    return rcpp_result_gen;
+END_RCPP
+}
+
+// png_to_escpos_raw
+Rcpp::RawVector png_to_escpos_raw(Rcpp::RawVector png, bool color, std::string dither, int threads, bool compress, std::string raster, std::string equalise, double gamma, double contrast, int brightness, int background, int width, int rotate, Rcpp::IntegerVector printer);
+RcppExport SEXP _escpos_png_to_escpos_raw(SEXP pngSEXP, SEXP colorSEXP, SEXP ditherSEXP, SEXP threadsSEXP, SEXP compressSEXP, SEXP rasterSEXP, SEXP equaliseSEXP, SEXP gammaSEXP, SEXP contrastSEXP, SEXP brightnessSEXP, SEXP backgroundSEXP, SEXP widthSEXP, SEXP rotateSEXP, SEXP printerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::RawVector >::type png(pngSEXP);
+    Rcpp::traits::input_parameter< bool >::type color(colorSEXP);
+    Rcpp::traits::input_parameter< std::string >::type dither(ditherSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type compress(compressSEXP);
+    Rcpp::traits::input_parameter< std::string >::type raster(rasterSEXP);
+    Rcpp::traits::input_parameter< std::string >::type equalise(equaliseSEXP);
+    Rcpp::traits::input_parameter< double >::type gamma(gammaSEXP);
+    Rcpp::traits::input_parameter< double >::type contrast(contrastSEXP);
+    Rcpp::traits::input_parameter< int >::type brightness(brightnessSEXP);
+    Rcpp::traits::input_parameter< int >::type background(backgroundSEXP);
+    Rcpp::traits::input_parameter< int >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< int >::type rotate(rotateSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type printer(printerSEXP);
+    rcpp_result_gen = Rcpp::wrap(png_to_escpos_raw(png, color, dither, threads, compress, raster, equalise, gamma, contrast, brightness, background, width, rotate, printer));
+    return rcpp_result_gen;
+END_RCPP
+}
+
+// png_to_escpos_print
+double png_to_escpos_print(Rcpp::RawVector png, std::string host, int port, int timeout, bool color, std::string dither, int threads, bool compress, std::string raster, std::string equalise, double gamma, double contrast, int brightness, int background, int width, int rotate, Rcpp::IntegerVector printer);
+RcppExport SEXP _escpos_png_to_escpos_print(SEXP pngSEXP, SEXP hostSEXP, SEXP portSEXP, SEXP timeoutSEXP, SEXP colorSEXP, SEXP ditherSEXP, SEXP threadsSEXP, SEXP compressSEXP, SEXP rasterSEXP, SEXP equaliseSEXP, SEXP gammaSEXP, SEXP contrastSEXP, SEXP brightnessSEXP, SEXP backgroundSEXP, SEXP widthSEXP, SEXP rotateSEXP, SEXP printerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::RawVector >::type png(pngSEXP);
+    Rcpp::traits::input_parameter< std::string >::type host(hostSEXP);
+    Rcpp::traits::input_parameter< int >::type port(portSEXP);
+    Rcpp::traits::input_parameter< int >::type timeout(timeoutSEXP);
+    Rcpp::traits::input_parameter< bool >::type color(colorSEXP);
+    Rcpp::traits::input_parameter< std::string >::type dither(ditherSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type compress(compressSEXP);
+    Rcpp::traits::input_parameter< std::string >::type raster(rasterSEXP);
+    Rcpp::traits::input_parameter< std::string >::type equalise(equaliseSEXP);
+    Rcpp::traits::input_parameter< double >::type gamma(gammaSEXP);
+    Rcpp::traits::input_parameter< double >::type contrast(contrastSEXP);
+    Rcpp::traits::input_parameter< int >::type brightness(brightnessSEXP);
+    Rcpp::traits::input_parameter< int >::type background(backgroundSEXP);
+    Rcpp::traits::input_parameter< int >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< int >::type rotate(rotateSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type printer(printerSEXP);
+    rcpp_result_gen = Rcpp::wrap(png_to_escpos_print(png, host, port, timeout, color, dither, threads, compress, raster, equalise, gamma, contrast, brightness, background, width, rotate, printer));
+    return rcpp_result_gen;
+END_RCPP
+}
+
+// png_to_escpos_batch
+Rcpp::List png_to_escpos_batch(Rcpp::List pngs, bool color, std::string dither, int threads, int workers, bool compress, std::string raster, std::string equalise, double gamma, double contrast, int brightness, int background, int width, int rotate, Rcpp::IntegerVector printer);
+RcppExport SEXP _escpos_png_to_escpos_batch(SEXP pngsSEXP, SEXP colorSEXP, SEXP ditherSEXP, SEXP threadsSEXP, SEXP workersSEXP, SEXP compressSEXP, SEXP rasterSEXP, SEXP equaliseSEXP, SEXP gammaSEXP, SEXP contrastSEXP, SEXP brightnessSEXP, SEXP backgroundSEXP, SEXP widthSEXP, SEXP rotateSEXP, SEXP printerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type pngs(pngsSEXP);
+    Rcpp::traits::input_parameter< bool >::type color(colorSEXP);
+    Rcpp::traits::input_parameter< std::string >::type dither(ditherSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type workers(workersSEXP);
+    Rcpp::traits::input_parameter< bool >::type compress(compressSEXP);
+    Rcpp::traits::input_parameter< std::string >::type raster(rasterSEXP);
+    Rcpp::traits::input_parameter< std::string >::type equalise(equaliseSEXP);
+    Rcpp::traits::input_parameter< double >::type gamma(gammaSEXP);
+    Rcpp::traits::input_parameter< double >::type contrast(contrastSEXP);
+    Rcpp::traits::input_parameter< int >::type brightness(brightnessSEXP);
+    Rcpp::traits::input_parameter< int >::type background(backgroundSEXP);
+    Rcpp::traits::input_parameter< int >::type width(widthSEXP);
+    Rcpp::traits::input_parameter< int >::type rotate(rotateSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type printer(printerSEXP);
+    rcpp_result_gen = Rcpp::wrap(png_to_escpos_batch(pngs, color, dither, threads, workers, compress, raster, equalise, gamma, contrast, brightness, background, width, rotate, printer));
+    return rcpp_result_gen;
+END_RCPP
+}
+
+// png_to_escpos_define
+Rcpp::RawVector png_to_escpos_define(Rcpp::RawVector png, std::string key, std::string memory, bool color, std::string dither, int threads, Rcpp::IntegerVector printer);
+RcppExport SEXP _escpos_png_to_escpos_define(SEXP pngSEXP, SEXP keySEXP, SEXP memorySEXP, SEXP colorSEXP, SEXP ditherSEXP, SEXP threadsSEXP, SEXP printerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::RawVector >::type png(pngSEXP);
+    Rcpp::traits::input_parameter< std::string >::type key(keySEXP);
+    Rcpp::traits::input_parameter< std::string >::type memory(memorySEXP);
+    Rcpp::traits::input_parameter< bool >::type color(colorSEXP);
+    Rcpp::traits::input_parameter< std::string >::type dither(ditherSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type printer(printerSEXP);
+    rcpp_result_gen = Rcpp::wrap(png_to_escpos_define(png, key, memory, color, dither, threads, printer));
+    return rcpp_result_gen;
+END_RCPP
+}
+
+// png_content_hash
+std::string png_content_hash(Rcpp::RawVector png, std::string salt);
+RcppExport SEXP _escpos_png_content_hash(SEXP pngSEXP, SEXP saltSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::RawVector >::type png(pngSEXP);
+    Rcpp::traits::input_parameter< std::string >::type salt(saltSEXP);
+    rcpp_result_gen = Rcpp::wrap(png_content_hash(png, salt));
+    return rcpp_result_gen;
+END_RCPP
+}
+
+// png_printer_profiles
+Rcpp::DataFrame png_printer_profiles();
+RcppExport SEXP _escpos_png_printer_profiles() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(png_printer_profiles());
+    return rcpp_result_gen;
+END_RCPP
+}
+
+// png_arena_stats
+Rcpp::NumericVector png_arena_stats();
+RcppExport SEXP _escpos_png_arena_stats() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(png_arena_stats());
     return rcpp_result_gen;
 END_RCPP
 }
 
 static const R_CallMethodDef CallEntries[] = {
-    {"_escpos_png_to_escpos_raster", (DL_FUNC) &_escpos_png_to_escpos_raster, 3},
+    {"_escpos_png_to_escpos_raster", (DL_FUNC) &_escpos_png_to_escpos_raster, 16},
+    {"_escpos_png_to_escpos_raw", (DL_FUNC) &_escpos_png_to_escpos_raw, 14},
+    {"_escpos_png_to_escpos_print", (DL_FUNC) &_escpos_png_to_escpos_print, 17},
+    {"_escpos_png_to_escpos_batch", (DL_FUNC) &_escpos_png_to_escpos_batch, 15},
+    {"_escpos_png_to_escpos_define", (DL_FUNC) &_escpos_png_to_escpos_define, 7},
+    {"_escpos_png_content_hash", (DL_FUNC) &_escpos_png_content_hash, 2},
+    {"_escpos_png_printer_profiles", (DL_FUNC) &_escpos_png_printer_profiles, 0},
+    {"_escpos_png_arena_stats", (DL_FUNC) &_escpos_png_arena_stats, 0},
     {NULL, NULL, 0}
 };
 
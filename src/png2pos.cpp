@@ -4,366 +4,398 @@ using namespace Rcpp;
 
 #include <stdlib.h>
 #include <stdio.h>
-#include <ctype.h>
-#include <unistd.h>
+#include <string.h>
+#include <vector>
 #include "lodepng.h"
+#include "png2pos_arena.h"
+#include "png2pos_convert.h"
+#include "png2pos_batch.h"
+#include "png2pos_hash.h"
+#include "png2pos_net.h"
+#include "png2pos_profile.h"
+
+/* dithering method for its R name, stops with an R error on unknown names */
+static enum png2pos_dither s_dither_method(const std::string &name) {
+  int method = png2pos_dither_from_name(name.c_str());
+  if (method < 0) {
+    Rcpp::stop("unknown dithering method '%s'", name);
+  }
+  return (enum png2pos_dither)method;
+}
 
-#ifdef LODEPNG_NO_COMPILE_ALLOCATORS
-/* modified lodepng allocators */
-
-void *lodepng_malloc(size_t size) {
-    /* for security reason I use calloc instead of malloc;
-       here we redefine lodepng allocator */
-    return calloc(size, 1);
+/* raster command set for its R name, stops with an R error on unknown names */
+static enum png2pos_raster s_raster_commands(const std::string &name) {
+  int raster = png2pos_raster_from_name(name.c_str());
+  if (raster < 0) {
+    Rcpp::stop("unknown raster command set '%s'", name);
+  }
+  return (enum png2pos_raster)raster;
 }
 
-void *lodepng_realloc(void *ptr, size_t new_size) {
-    return realloc(ptr, new_size);
+/* equalisation method for its R name, stops with an R error on unknown names */
+static enum png2pos_equalise s_equalise_method(const std::string &name) {
+  int equalise = png2pos_equalise_from_name(name.c_str());
+  if (equalise < 0) {
+    Rcpp::stop("unknown equalisation '%s'", name);
+  }
+  return (enum png2pos_equalise)equalise;
 }
 
-void lodepng_free(void *ptr) {
-    free(ptr);
+/* printer profile from R, as kept by pos_printer_profile(): width, dpi,
+   band height, receive buffer and speed; empty for the default printer */
+static void s_printer(struct png2pos_options *opt,
+                      const Rcpp::IntegerVector &printer) {
+  if (printer.size() == 0) {
+    return;
+  }
+  bool valid = printer.size() == 5;
+  for (R_xlen_t i = 0; valid && i != printer.size(); ++i) {
+    valid = printer[i] > 0; /* also rules out NA */
+  }
+  if (!valid) {
+    Rcpp::stop("printer profile needs a positive width, dpi, band height, buffer and speed");
+  }
+  /* feeds are counted in dot rows, GS P sets the unit to at most 1/255 in */
+  if (printer[1] > 255) {
+    Rcpp::stop("printer profile dpi has to be at most 255");
+  }
+
+  /* the raster command set was checked against the profile in R */
+  struct png2pos_profile profile = {
+    "", (unsigned int)printer[0], (unsigned int)printer[1],
+    (unsigned int)printer[2], PNG2POS_RASTER_BIT(opt->raster),
+    (unsigned int)printer[3], (unsigned int)printer[4]
+  };
+  png2pos_profile_apply(&profile, opt);
 }
-#endif
-
-/* number of dots/lines in vertical direction in one F112 command
-   set GS8L_MAX_Y env. var. to <= 128u for Epson TM-J2000/J2100
-   default value is 1662, TM-T70, TM-T88 etc. */
-#ifndef GS8L_MAX_Y
-#define GS8L_MAX_Y 1662
-#endif
-
-/* max image width printer is able to process;
-   printer_max_width must be divisible by 8!! */
-#ifndef PRINTER_MAX_WIDTH
-#define PRINTER_MAX_WIDTH 512u
-#endif
-
-struct dithering_matrix {
-    int dx; /* x-offset */
-    int dy; /* y-offset */
-    int v; /* error = v * 1/1,024th of value */
-};
-
-struct app_config {
-    unsigned int cut;
-    unsigned int photo;
-    char align;
-    unsigned int rotate;
-    const char *output;
-    unsigned int gs8l_max_y;
-    unsigned int printer_max_width;
-    unsigned int speed;
-};
-
-/* app configuration */
-struct app_config config = {
-    .cut = 0,
-    .photo = 0,
-    .align = '?',
-    .rotate = 0,
-    .output = NULL,
-    .gs8l_max_y = GS8L_MAX_Y,
-    .printer_max_width = PRINTER_MAX_WIDTH,
-    .speed = 0
-};
-
-unsigned char s_add_to_byte(unsigned char v, int d) {
-    int a = v + d;
-    if (a > 0xff) {
-        a = 0xff;
-    } else if (a < 0) {
-        a = 0;
+
+/* stops with an R error if a conversion of the batch threw; only called
+   once all workers have returned */
+static void s_batch_failure(const std::vector<struct png2pos_job> &jobs) {
+  for (size_t i = 0; i != jobs.size(); ++i) {
+    if (!jobs[i].failure.empty()) {
+      Rcpp::stop("converting image %d failed: %s", (int)(i + 1),
+                 jobs[i].failure);
     }
-    return a;
+  }
+}
+
+/* per call converter options from the R arguments */
+static struct png2pos_options s_options(bool color, const std::string &dither,
+                                        int threads, bool compress,
+                                        const std::string &raster,
+                                        const std::string &equalise = "global",
+                                        double gamma = 1, double contrast = 1,
+                                        int brightness = 0,
+                                        int background = 255,
+                                        int width = 0, int rotate = 0,
+                                        const Rcpp::IntegerVector &printer =
+                                          Rcpp::IntegerVector()) {
+  struct png2pos_options opt;
+  png2pos_options_init(&opt);
+
+  opt.photo = color ? 1 : 0;
+  opt.dither = s_dither_method(dither);
+  opt.threads = threads > 1 ? threads : 1;
+  opt.compress = compress ? 1 : 0;
+  opt.raster = s_raster_commands(raster);
+  opt.tone.equalise = s_equalise_method(equalise);
+  opt.tone.gamma = gamma > 0 ? gamma : 1;
+  opt.tone.contrast = contrast;
+  opt.tone.brightness = brightness;
+  opt.background = background < 0 ? 0 : background > 255 ? 255 : background;
+  opt.width = width > 0 ? width : 0;
+
+  rotate = (rotate % 360 + 360) % 360;
+  if (rotate % 90) {
+    Rcpp::stop("rotation must be a multiple of 90 degrees");
+  }
+  opt.rotate = rotate;
+
+  s_printer(&opt, printer);
+
+  return opt;
 }
 
 //' @keywords internal
 // [[Rcpp::export]]
-std::string png_to_escpos_raster(std::string png_file, std::string raster_path, bool color = false) {
+Rcpp::CharacterVector png_to_escpos_raster(Rcpp::CharacterVector png_files, Rcpp::CharacterVector raster_paths, bool color = false, std::string dither = "jjn", int threads = 1, int workers = 1, bool compress = false, std::string raster = "gs8l", std::string equalise = "global", double gamma = 1, double contrast = 1, int brightness = 0, int background = 255, int width = 0, int rotate = 0, Rcpp::IntegerVector printer = Rcpp::IntegerVector::create()) {
 
-  unsigned char *img_rgba = NULL;
-  unsigned char *img_grey = NULL;
-  unsigned char *img_bw = NULL;
+  struct png2pos_options opt = s_options(color, dither, threads, compress,
+                                         raster, equalise, gamma, contrast,
+                                         brightness, background, width,
+                                         rotate, printer);
 
-  config.photo = color ? 1 : 0;
-  config.printer_max_width &= ~0x7u;
+  if (png_files.size() != raster_paths.size()) {
+    Rcpp::stop("need one raster file per PNG file");
+  }
 
-  FILE *fout = fopen(raster_path.c_str(), "wb");
-  setvbuf(fout, NULL, _IOFBF, 8192);
+  /* the workers load every PNG and write its stream to the raster file
+     themselves */
+  std::vector<struct png2pos_job> jobs(png_files.size());
 
-  const unsigned char ESC_INIT[2] = {
-      /* ESC @, Initialize printer, p. 412 */
-      0x1b, 0x40
-  };
+  for (R_xlen_t i = 0; i < png_files.size(); ++i) {
+    jobs[i].png = NULL;
+    jobs[i].png_size = 0;
+    jobs[i].path = Rcpp::as<std::string>(png_files[i]);
+    jobs[i].out_path = Rcpp::as<std::string>(raster_paths[i]);
+    jobs[i].error = 0;
+  }
 
-  fwrite(ESC_INIT, 1, sizeof ESC_INIT, fout);
-  fflush(fout);
+  png2pos_convert_batch(jobs.data(), jobs.size(), &opt,
+                        workers > 1 ? workers : 1);
 
-  const char *input = png_file.c_str();
+  Rcpp::CharacterVector res(jobs.size());
 
-  /* load RGBA PNG */
-  unsigned int img_w = 0;
-  unsigned int img_h = 0;
-  unsigned int lodepng_error = lodepng_decode32_file(&img_rgba,
-                                                     &img_w, &img_h, input);
+  for (size_t i = 0; i != jobs.size(); ++i) {
+    if (jobs[i].error) {
+      remove(jobs[i].out_path.c_str());
+      res[i] = "";
+    } else {
+      res[i] = jobs[i].out_path;
+    }
+  }
+  s_batch_failure(jobs);
 
-  if (lodepng_error) {
-    // fprintf(stderr, "Could not load and process input PNG file, %s\n",
-    //         lodepng_error_text(lodepng_error));
-    return("");
+  return(res);
+
+}
+
+//' @keywords internal
+// [[Rcpp::export]]
+Rcpp::RawVector png_to_escpos_raw(Rcpp::RawVector png, bool color = false, std::string dither = "jjn", int threads = 1, bool compress = false, std::string raster = "gs8l", std::string equalise = "global", double gamma = 1, double contrast = 1, int brightness = 0, int background = 255, int width = 0, int rotate = 0, Rcpp::IntegerVector printer = Rcpp::IntegerVector::create()) {
+
+  struct png2pos_options opt = s_options(color, dither, threads, compress,
+                                         raster, equalise, gamma, contrast,
+                                         brightness, background, width,
+                                         rotate, printer);
+
+  /* the PNG is decoded straight out of the R vector */
+  std::vector<unsigned char> out;
+  struct png2pos_sink sink;
+  png2pos_sink_buffer(&sink, &out);
+
+  struct png2pos_stats stats;
+  unsigned int error = png2pos_convert(png.begin(), png.size(), &opt, &sink,
+                                       &stats);
+
+  if (error) {
+    return(Rcpp::RawVector(0));
   }
 
-  if (img_w > config.printer_max_width) {
-    // fprintf(stderr, "Image width %u px exceeds the printer's"
-    //           " capability (%u px)\n", img_w, config.printer_max_width);
-    return("");
+  Rcpp::RawVector res(out.begin(), out.end());
+  if (compress) {
+    res.attr("bytes_saved") = (double)stats.saved;
   }
+  res.attr("seconds") = stats.seconds;
 
-  unsigned int histogram[256] = { 0 };
+  return(res);
 
-  /* convert RGBA to greyscale */
-  unsigned int img_grey_size = img_h * img_w;
+}
 
-  img_grey = (unsigned char *)calloc(img_grey_size, 1);
-  if (!img_grey) {
-    // fprintf(stderr, "Could not allocate enough memory\n");
-    return("");// goto fail;
+//' @keywords internal
+// [[Rcpp::export]]
+double png_to_escpos_print(Rcpp::RawVector png, std::string host, int port = 9100, int timeout = 30, bool color = false, std::string dither = "jjn", int threads = 1, bool compress = false, std::string raster = "gs8l", std::string equalise = "global", double gamma = 1, double contrast = 1, int brightness = 0, int background = 255, int width = 0, int rotate = 0, Rcpp::IntegerVector printer = Rcpp::IntegerVector::create()) {
+
+  struct png2pos_options opt = s_options(color, dither, threads, compress,
+                                         raster, equalise, gamma, contrast,
+                                         brightness, background, width,
+                                         rotate, printer);
+
+  char error_text[256];
+  intptr_t s = png2pos_connect(host.c_str(), std::to_string(port).c_str(),
+                               timeout > 0 ? timeout : 0, error_text);
+  if (s == -1) {
+    Rcpp::stop("%s", error_text);
   }
 
-  for (unsigned int i = 0; i != img_grey_size; ++i) {
-    /* A */
-    unsigned int a = img_rgba[(i << 2) | 3];
-
-    /* RGBA → RGB → L* */
-    unsigned int r = (255 - a) + a / 255 * img_rgba[i << 2];
-    unsigned int g = (255 - a) + a / 255 * img_rgba[(i << 2) | 1];
-    unsigned int b = (255 - a) + a / 255 * img_rgba[(i << 2) | 2];
-    unsigned int L = (55 * r + 182 * g + 18 * b) / 255;
+  /* every band goes out as soon as it is packed */
+  struct png2pos_sink sink;
+  png2pos_sink_socket(&sink, s);
+
+  /* the connection is closed whatever the converter throws */
+  struct png2pos_stats stats;
+  unsigned int error, lost;
+  try {
+    error = png2pos_convert(png.begin(), png.size(), &opt, &sink, &stats);
+    lost = png2pos_sink_flush(&sink);
+  } catch (...) {
+    png2pos_disconnect(s);
+    throw;
+  }
 
-    img_grey[i] = L;
+  png2pos_disconnect(s);
 
-    /* prepare a histogram for HEA */
-    ++histogram[img_grey[i]];
+  if (lost) {
+    png2pos_send_error(lost, error_text);
+    Rcpp::stop("sending to %s failed: %s", host, error_text);
+  }
+  if (error) {
+    Rcpp::stop("could not convert the image");
   }
 
-  free(img_rgba);
-  img_rgba = NULL;
+  return(stats.seconds);
 
-  {
-    /* -p hints */
-    unsigned int colors = 0;
+}
 
-    for (unsigned int i = 0; i != 256; ++i) {
-      if (histogram[i]) {
-        ++colors;
-      }
-    }
-    if (colors < 16 && config.photo) {
-      fprintf(stderr, "Image seems to be B/W. -p is probably"
-                " not good option this time\n");
-    }
-    if (colors >= 16 && !config.photo) {
-      fprintf(stderr, "Image seems to be greyscale or colored."
-                " Maybe you should use option -p for better results\n");
+//' @keywords internal
+// [[Rcpp::export]]
+Rcpp::List png_to_escpos_batch(Rcpp::List pngs, bool color = false, std::string dither = "jjn", int threads = 1, int workers = 1, bool compress = false, std::string raster = "gs8l", std::string equalise = "global", double gamma = 1, double contrast = 1, int brightness = 0, int background = 255, int width = 0, int rotate = 0, Rcpp::IntegerVector printer = Rcpp::IntegerVector::create()) {
+
+  struct png2pos_options opt = s_options(color, dither, threads, compress,
+                                         raster, equalise, gamma, contrast,
+                                         brightness, background, width,
+                                         rotate, printer);
+
+  /* everything R is read here, the workers only see plain C++ data */
+  std::vector<struct png2pos_job> jobs(pngs.size());
+
+  for (R_xlen_t i = 0; i < pngs.size(); ++i) {
+    SEXP png = pngs[i];
+
+    if (TYPEOF(png) == RAWSXP) {
+      jobs[i].png = RAW(png);
+      jobs[i].png_size = XLENGTH(png);
+    } else if (TYPEOF(png) == STRSXP && XLENGTH(png) == 1) {
+      jobs[i].png = NULL;
+      jobs[i].png_size = 0;
+      jobs[i].path = Rcpp::as<std::string>(png);
+    } else {
+      Rcpp::stop("element %d is neither a raw vector nor a file path", i + 1);
     }
+    jobs[i].error = 0;
   }
 
-  /* post-processing convert to B/W bitmap */
-  if (config.photo) {
-    /* Histogram Equalization Algorithm */
-    for (unsigned int i = 1; i != 256; ++i) {
-      histogram[i] += histogram[i - 1];
-    }
-    for (unsigned int i = 0; i != img_grey_size; ++i) {
-      img_grey[i] = 255 * histogram[img_grey[i]] / img_grey_size;
-    }
+  png2pos_convert_batch(jobs.data(), jobs.size(), &opt,
+                        workers > 1 ? workers : 1);
+  s_batch_failure(jobs);
 
-    /* Jarvis, Judice, and Ninke Dithering
-     http://www.tannerhelland.com/4660/
-     dithering-eleven-algorithms-source-code/
-
-     In the same year that Floyd and Steinberg published their
-     famous dithering algorithm, a lesser-known – but much more
-     powerful – algorithm was also published. With this
-     algorithm, the error is distributed to three times as many
-     pixels as in Floyd-Steinberg, leading to much smoother –
-     and more subtle – output. */
-    const struct dithering_matrix dithering_matrix[12] = {
-      /* for simplicity of computation, all standard dithering
-       formulas push the error forward, never backward */
-      {.dx =  1, .dy = 0, .v = 149 /* 1024 * 7 / 48 */},
-      {.dx =  2, .dy = 0, .v = 107 /* 1024 * 5 / 48 */},
-      {.dx = -2, .dy = 1, .v =  64 /* 1024 * 3 / 48 */},
-      {.dx = -1, .dy = 1, .v = 107 /* 1024 * 5 / 48 */},
-      {.dx =  0, .dy = 1, .v = 149 /* 1024 * 7 / 48 */},
-      {.dx =  1, .dy = 1, .v = 107 /* 1024 * 5 / 48 */},
-      {.dx =  2, .dy = 1, .v =  64 /* 1024 * 3 / 48 */},
-      {.dx = -2, .dy = 2, .v =  21 /* 1024 * 1 / 48 */},
-      {.dx = -1, .dy = 2, .v =  64 /* 1024 * 3 / 48 */},
-      {.dx =  0, .dy = 2, .v = 107 /* 1024 * 5 / 48 */},
-      {.dx =  1, .dy = 2, .v =  64 /* 1024 * 3 / 48 */},
-      {.dx =  2, .dy = 2, .v =  21 /* 1024 * 1 / 48 */}
-    };
-
-    for (unsigned int i = 0; i != img_grey_size; ++i) {
-      unsigned int o = img_grey[i];
-      unsigned int n = o <= 0x80 ? 0x00 : 0xff;
-
-      int x = i % img_w;
-      int y = i / img_w;
-
-      img_grey[i] = n;
-      for (unsigned int j = 0; j != 12; ++j) {
-        int x0 = x + dithering_matrix[j].dx;
-        int y0 = y + dithering_matrix[j].dy;
-
-        if (x0 > (int) img_w - 1 || x0 < 0
-              || y0 > (int) img_h - 1 || y0 < 0) {
-
-          continue;
-        }
-        /* the residual quantization error, warning: !have to
-         overcast to signed int before calculation! */
-        int d = (int) (o - n) * dithering_matrix[j].v / 1024;
-
-        /* keep a value in the <min; max> interval */
-        img_grey[x0 + img_w * y0] =
-        s_add_to_byte(img_grey[x0 + img_w * y0], d);
+  Rcpp::List res(jobs.size());
+
+  for (size_t i = 0; i != jobs.size(); ++i) {
+    if (jobs[i].error) {
+      res[i] = Rcpp::RawVector(0);
+    } else {
+      Rcpp::RawVector out(jobs[i].out.begin(), jobs[i].out.end());
+      if (compress) {
+        out.attr("bytes_saved") = (double)jobs[i].stats.saved;
       }
+      out.attr("seconds") = jobs[i].stats.seconds;
+      res[i] = out;
     }
+    /* release each stream as soon as R has its copy */
+    std::vector<unsigned char>().swap(jobs[i].out);
   }
-  /* canvas size is width of printable area */
-  unsigned int canvas_w = config.printer_max_width;
 
-  unsigned int img_bw_size = img_h * (canvas_w >> 3);
+  return(res);
 
-  img_bw = (unsigned char *)calloc(img_bw_size, 1);
-  if (!img_bw) {
-    fprintf(stderr, "Could not allocate enough memory\n");
-  }
+}
 
-  /* align rotated image to the right border */
-  if (config.rotate && config.align == '?') {
-    config.align = 'R';
+//' @keywords internal
+// [[Rcpp::export]]
+Rcpp::RawVector png_to_escpos_define(Rcpp::RawVector png, std::string key, std::string memory = "nv", bool color = false, std::string dither = "jjn", int threads = 1, Rcpp::IntegerVector printer = Rcpp::IntegerVector::create()) {
+
+  struct png2pos_options opt = s_options(color, dither, threads, false,
+                                         "gs8l", "global", 1, 1, 0, 255, 0, 0,
+                                         printer);
+
+  if (memory == "nv") {
+    opt.store = PNG2POS_STORE_NV;
+  } else if (memory == "download") {
+    opt.store = PNG2POS_STORE_DOWNLOAD;
+  } else {
+    Rcpp::stop("unknown graphics memory '%s'", memory);
   }
 
-  /* left offset */
-  unsigned int offset = 0;
+  if (key.size() != 2 || key[0] < 32 || key[0] > 126 || key[1] < 32 ||
+      key[1] > 126) {
+    Rcpp::stop("key code has to be two printable ASCII characters");
+  }
+  opt.key[0] = key[0];
+  opt.key[1] = key[1];
 
-  switch (config.align) {
-  case 'C':
-    offset = (canvas_w - img_w) / 2;
-    break;
+  std::vector<unsigned char> out;
+  struct png2pos_sink sink;
+  png2pos_sink_buffer(&sink, &out);
 
-  case 'R':
-    offset = canvas_w - img_w;
-    break;
+  unsigned int error = png2pos_convert(png.begin(), png.size(), &opt, &sink,
+                                       NULL);
 
-  case 'L':
-  case '?':
-  default:
-    offset = 0;
+  if (error) {
+    return(Rcpp::RawVector(0));
   }
 
-  /* compress bytes into bitmap */
-  for (unsigned int i = 0; i != img_grey_size; ++i) {
-    unsigned int idx = config.rotate ? img_grey_size - 1 - i : i;
+  return(Rcpp::RawVector(out.begin(), out.end()));
 
-    if (img_grey[idx] <= 0x80) {
-      unsigned int x = i % img_w + offset;
-      unsigned int y = i / img_w;
+}
 
-      img_bw[(y * canvas_w + x) >> 3] |= 0x80 >> (x & 0x07);
-    }
-  }
+//' @keywords internal
+// [[Rcpp::export]]
+std::string png_content_hash(Rcpp::RawVector png, std::string salt = "") {
 
-  free(img_grey);
-  img_grey = NULL;
+  uint64_t h = png2pos_hash(png.begin(), png.size(), PNG2POS_HASH_INIT);
+  h = png2pos_hash(salt.data(), salt.size(), h);
 
-  /* chunking, l = lines already printed, currently processing a
-   chunk of height k */
-  for (unsigned int l = 0, k = config.gs8l_max_y; l < img_h; l += k) {
+  char hex[17];
+  snprintf(hex, sizeof hex, "%016llx", (unsigned long long)h);
 
-    if (k > img_h - l) {
-      k = img_h - l;
-    }
+  return(std::string(hex));
 
-    const unsigned int f112_p = 10 + k * (canvas_w >> 3);
-    unsigned char ESC_STORE[17];
-
-    ESC_STORE[ 0] = 0x1d; /* GS 8 L, Store the graphics data in the print buffer (raster format), p. 252 */
-    ESC_STORE[ 1] = 0x38;
-    ESC_STORE[ 2] = 0x4c;
-    ESC_STORE[ 3] = f112_p & 0xff; /* p1 p2 p3 p4 */
-    ESC_STORE[ 4] = f112_p >> 8 & 0xff;
-    ESC_STORE[ 5] = f112_p >> 16 & 0xff;
-    ESC_STORE[ 6] = f112_p >> 24 & 0xff;
-    ESC_STORE[ 7] = 0x30; /* Function 112 */
-    ESC_STORE[ 8] = 0x70;
-    ESC_STORE[ 9] = 0x30;
-    ESC_STORE[10] = 0x01; /* bx by, zoom */
-    ESC_STORE[11] = 0x01;
-    ESC_STORE[12] = 0x31; /* c, single-color printing model */
-    ESC_STORE[13] = canvas_w & 0xff; /* xl, xh, number of dots in the horizontal direction */
-    ESC_STORE[14] = canvas_w >> 8 & 0xff;
-    ESC_STORE[15] = k & 0xff; /* yl, yh, number of dots in the vertical direction */
-    ESC_STORE[16] = k >> 8 & 0xff;
-
-
-    // unsigned char ESC_STORE[17] = {
-    //   /* GS 8 L, Store the graphics data in the print buffer
-    //    (raster format), p. 252 */
-    //   0x1d, 0x38, 0x4c,
-    //   /* p1 p2 p3 p4 */
-    //   f112_p & 0xff, f112_p >> 8 & 0xff, f112_p >> 16 & 0xff,
-    //   f112_p >> 24 & 0xff,
-    //   /* Function 112 */
-    //   0x30, 0x70, 0x30,
-    //   /* bx by, zoom */
-    //   0x01, 0x01,
-    //   /* c, single-color printing model */
-    //   0x31,
-    //   /* xl, xh, number of dots in the horizontal direction */
-    //   canvas_w & 0xff, canvas_w >> 8 & 0xff,
-    //   /* yl, yh, number of dots in the vertical direction */
-    //   k & 0xff, k >> 8 & 0xff
-    // };
-    fwrite(ESC_STORE, 1, sizeof ESC_STORE, fout);
-    fwrite(&img_bw[l * (canvas_w >> 3)], 1, k * (canvas_w >> 3), fout);
-
-    const unsigned char ESC_FLUSH[7] = {
-      /* GS ( L, Print the graphics data in the print buffer,
-       p. 241 Moves print position to the left side of the
-       print area after printing of graphics data is
-       completed */
-      0x1d, 0x28, 0x4c, 0x02, 0x00, 0x30,
-      /* Fn 50 */
-      0x32
-    };
-    fwrite(ESC_FLUSH, 1, sizeof ESC_FLUSH, fout);
-    fflush(fout);
-  }
+}
 
-  free(img_bw);
-  img_bw = NULL;
+//' @keywords internal
+// [[Rcpp::export]]
+Rcpp::DataFrame png_printer_profiles() {
 
-  free(img_rgba);
-  img_rgba = NULL;
+  unsigned int n = png2pos_profile_count();
+  Rcpp::CharacterVector name(n), raster(n);
+  Rcpp::IntegerVector width(n), dpi(n), band_height(n), buffer(n), speed(n);
 
-  free(img_grey);
-  img_grey = NULL;
+  for (unsigned int i = 0; i != n; ++i) {
+    const struct png2pos_profile *p = png2pos_profile_at(i);
+    std::string taken;
 
-  free(img_bw);
-  img_bw = NULL;
+    for (unsigned int r = 0; png2pos_raster_name((enum png2pos_raster)r);
+         ++r) {
+      if (p->rasters & PNG2POS_RASTER_BIT(r)) {
+        taken += taken.empty() ? "" : ",";
+        taken += png2pos_raster_name((enum png2pos_raster)r);
+      }
+    }
 
-  if (fout && fout != stdout) {
-    fclose(fout);
-    fout = NULL;
+    name[i] = p->name;
+    width[i] = p->width;
+    dpi[i] = p->dpi;
+    band_height[i] = p->gs8l_max_y;
+    raster[i] = taken;
+    buffer[i] = p->buffer;
+    speed[i] = p->speed;
   }
 
-  return(raster_path);
+  return(Rcpp::DataFrame::create(
+    Rcpp::Named("name") = name,
+    Rcpp::Named("width") = width,
+    Rcpp::Named("dpi") = dpi,
+    Rcpp::Named("band_height") = band_height,
+    Rcpp::Named("raster") = raster,
+    Rcpp::Named("buffer") = buffer,
+    Rcpp::Named("speed") = speed,
+    Rcpp::Named("stringsAsFactors") = false
+  ));
 
 }
 
+//' @keywords internal
+// [[Rcpp::export]]
+Rcpp::NumericVector png_arena_stats() {
+
+  struct png2pos_arena_stats stats;
+  png2pos_arena_stats(&stats);
 
+  return(Rcpp::NumericVector::create(
+    Rcpp::Named("peak") = (double)stats.peak,
+    Rcpp::Named("kept") = (double)stats.kept,
+    Rcpp::Named("blocks") = (double)stats.blocks
+  ));
+
+}
@@ -0,0 +1,280 @@
+#include <stdlib.h>
+#include <string.h>
+#include "png2pos_arena.h"
+
+/* every allocation starts on a multiple of ALIGN and has its size and size
+   class in the HEADER bytes in front of it */
+#define ALIGN 16u
+#define HEADER 16u
+
+/* smallest block taken from the heap */
+#define BLOCK_MIN (1u << 20)
+
+/* size classes: 128 bytes and below share the first, above that every
+   power of two is split into eight, so a class wastes at most an eighth;
+   the last class is 2^57 bytes, more is never asked for */
+#define CLASS_MIN 128u
+#define CLASSES 401u
+
+#define ROUND(n) (((n) + (ALIGN - 1)) & ~(size_t)(ALIGN - 1))
+
+/* a block of arena memory, data follows the (padded) struct */
+struct s_block {
+  struct s_block *next; /* the block before, still in use by the job */
+  size_t size; /* bytes of data */
+  size_t used;
+};
+
+#define DATA(b) ((unsigned char *)(b) + ROUND(sizeof(struct s_block)))
+
+/* in front of every allocation */
+struct s_header {
+  size_t size; /* bytes asked for */
+  unsigned int cls; /* size class, the bytes reserved are s_class_size() */
+};
+
+struct s_arena {
+  struct s_block *block; /* the block allocations are carved out of */
+  unsigned int active; /* a job is running */
+  void *last; /* most recent allocation, can be given back or grown */
+  void *freed[CLASSES]; /* freed allocations by size class, linked through
+                          their first bytes */
+  size_t in_use; /* bytes carved out of all blocks */
+  size_t peak; /* most bytes in_use was during the job */
+  size_t blocks; /* blocks taken from the heap, ever */
+
+  ~s_arena() {
+    while (block) {
+      struct s_block *next = block->next;
+      free(block);
+      block = next;
+    }
+  }
+};
+
+static thread_local struct s_arena arena;
+
+static struct s_header *s_head(const void *p) {
+  return (struct s_header *)((unsigned char *)p - HEADER);
+}
+
+/* smallest class holding size bytes, CLASSES if there is none */
+static unsigned int s_class(size_t size) {
+  if (size <= CLASS_MIN) {
+    return 0;
+  }
+  if ((unsigned long long)(size - 1) >> 57) {
+    return CLASSES;
+  }
+
+  /* size - 1 = 2^e * 1.f, classes 2^e * (1 + 1/8, 1 + 2/8, ... 2) */
+  size_t m = size - 1;
+  unsigned int e = 0;
+  while (m >> (e + 1)) {
+    ++e;
+  }
+  return (e - 7) * 8 + (unsigned int)((m >> (e - 3)) & 7) + 1;
+}
+
+static size_t s_class_size(unsigned int cls) {
+  if (!cls) {
+    return CLASS_MIN;
+  }
+  unsigned int e = (cls - 1) / 8 + 7;
+  return ((size_t)1 << e) + ((size_t)((cls - 1) % 8 + 1) << (e - 3));
+}
+
+/* whether p was handed out by the arena */
+static int s_owned(const void *p) {
+  for (struct s_block *b = arena.block; b; b = b->next) {
+    if ((const unsigned char *)p >= DATA(b)
+        && (const unsigned char *)p < DATA(b) + b->size) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void s_take(size_t bytes) {
+  arena.in_use += bytes;
+  if (arena.in_use > arena.peak) {
+    arena.peak = arena.in_use;
+  }
+}
+
+static struct s_block *s_block_new(size_t size) {
+  struct s_block *b = (struct s_block *)malloc(ROUND(sizeof(struct s_block))
+                                               + size);
+  if (b) {
+    b->size = size;
+    b->used = 0;
+    ++arena.blocks;
+  }
+  return b;
+}
+
+void png2pos_arena_begin(void) {
+  if (arena.active) {
+    png2pos_arena_end();
+  }
+  if (arena.block) {
+    arena.block->used = 0;
+  }
+
+  arena.active = 1;
+  arena.last = NULL;
+  memset(arena.freed, 0, sizeof arena.freed);
+  arena.in_use = 0;
+  arena.peak = 0;
+}
+
+void png2pos_arena_end(void) {
+  arena.active = 0;
+  arena.last = NULL;
+  memset(arena.freed, 0, sizeof arena.freed);
+
+  struct s_block *b = arena.block;
+  if (!b) {
+    return;
+  }
+
+  /* a job that needed several blocks gets one of its peak size next time,
+     so the same job again allocates nothing; a block above
+     PNG2POS_ARENA_KEEP is kept while the jobs still need most of it */
+  size_t size = arena.peak < BLOCK_MIN ? BLOCK_MIN : ROUND(arena.peak);
+
+  if (b->next || (b->size > PNG2POS_ARENA_KEEP
+                  && (size <= PNG2POS_ARENA_KEEP || size < b->size / 2))) {
+    while (b) {
+      struct s_block *next = b->next;
+      free(b);
+      b = next;
+    }
+
+    b = arena.block = s_block_new(size);
+    if (b) {
+      b->next = NULL;
+    }
+  }
+
+  if (arena.block) {
+    arena.block->used = 0;
+  }
+}
+
+void *png2pos_arena_alloc(size_t size) {
+  if (!arena.active) {
+    return malloc(size ? size : 1);
+  }
+
+  unsigned int cls = s_class(size);
+  if (cls == CLASSES) {
+    return NULL;
+  }
+
+  /* memory given back earlier in the job */
+  unsigned char *p = (unsigned char *)arena.freed[cls];
+  if (p) {
+    memcpy(&arena.freed[cls], p, sizeof(void *));
+    s_head(p)->size = size;
+    return p;
+  }
+
+  size_t need = HEADER + s_class_size(cls);
+  struct s_block *b = arena.block;
+
+  if (!b || b->size - b->used < need) {
+    size_t grow = b ? 2 * b->size : BLOCK_MIN;
+    if (grow < need) {
+      grow = need;
+    }
+
+    struct s_block *nb = s_block_new(grow);
+    if (!nb) {
+      return NULL;
+    }
+    nb->next = b;
+    arena.block = b = nb;
+  }
+
+  p = DATA(b) + b->used + HEADER;
+  s_head(p)->size = size;
+  s_head(p)->cls = cls;
+  b->used += need;
+  s_take(need);
+
+  arena.last = p;
+  return p;
+}
+
+void *png2pos_arena_realloc(void *p, size_t size) {
+  if (!p) {
+    return png2pos_arena_alloc(size);
+  }
+  if (!s_owned(p)) {
+    return realloc(p, size);
+  }
+
+  struct s_header *h = s_head(p);
+  unsigned int cls = s_class(size);
+
+  /* the most recent allocation grows or shrinks where it is */
+  if (p == arena.last && cls != CLASSES) {
+    struct s_block *b = arena.block;
+    size_t start = (unsigned char *)p - HEADER - DATA(b);
+    size_t need = HEADER + s_class_size(cls);
+
+    if (start + need <= b->size) {
+      arena.in_use -= b->used - start;
+      b->used = start + need;
+      s_take(need);
+      h->size = size;
+      h->cls = cls;
+      return p;
+    }
+  }
+
+  if (cls <= h->cls) {
+    h->size = size;
+    return p;
+  }
+
+  size_t old = h->size;
+  void *q = png2pos_arena_alloc(size);
+  if (q) {
+    memcpy(q, p, old);
+    png2pos_arena_free(p);
+  }
+  return q;
+}
+
+void png2pos_arena_free(void *p) {
+  if (!p) {
+    return;
+  }
+  if (!s_owned(p)) {
+    free(p);
+    return;
+  }
+
+  if (p == arena.last) {
+    struct s_block *b = arena.block;
+    size_t start = (unsigned char *)p - HEADER - DATA(b);
+
+    arena.in_use -= b->used - start;
+    b->used = start;
+    arena.last = NULL;
+    return;
+  }
+
+  /* anything else waits in its class for an allocation of that size */
+  unsigned int cls = s_head(p)->cls;
+  memcpy(p, &arena.freed[cls], sizeof(void *));
+  arena.freed[cls] = p;
+}
+
+void png2pos_arena_stats(struct png2pos_arena_stats *stats) {
+  stats->peak = arena.peak;
+  stats->kept = arena.block ? arena.block->size : 0;
+  stats->blocks = arena.blocks;
+}
@@ -0,0 +1,67 @@
+/* png2pos_arena.h, per-thread scratch memory for the png2pos converter
+
+   Between png2pos_arena_begin() and png2pos_arena_end() the allocations of
+   a thread are carved out of that thread's arena: the decoder's (through
+   the lodepng_malloc / lodepng_realloc / lodepng_free hooks) and the
+   converter's own. Memory freed during the job is reused by later
+   allocations of the same size class, whatever order the decoder frees
+   it in; all of it is given back at once when the job ends, and the arena
+   keeps its memory for the next job, merged into one block, so a thread
+   converting images of similar size stops touching the heap after the
+   first one. Outside a job the functions fall back to malloc / realloc /
+   free.
+
+   The arena lives as long as its thread. Batch workers are started for
+   every batch, so they reuse their arenas from one image of the batch to
+   the next, but each batch starts with empty ones. */
+
+#ifndef PNG2POS_ARENA_H
+#define PNG2POS_ARENA_H
+
+#include <stddef.h>
+
+/* an arena keeps more memory than this between jobs only while the jobs
+   still need most of it */
+#define PNG2POS_ARENA_KEEP (64u << 20)
+
+/* start a job on the calling thread; jobs do not nest, one still
+   running is ended first */
+void png2pos_arena_begin(void);
+
+/* end the job, everything allocated since png2pos_arena_begin() is
+   released */
+void png2pos_arena_end(void);
+
+/* size bytes aligned to 16, not cleared; NULL if memory ran out */
+void *png2pos_arena_alloc(size_t size);
+
+/* like realloc(); memory from before the job is handed to realloc() */
+void *png2pos_arena_realloc(void *p, size_t size);
+
+/* like free(); the most recent allocation of a job is given back to the
+   arena at once, others are kept for allocations of their size class */
+void png2pos_arena_free(void *p);
+
+/* what the calling thread's arena holds */
+struct png2pos_arena_stats {
+  size_t peak; /* bytes the last job needed at most */
+  size_t kept; /* bytes kept between jobs */
+  size_t blocks; /* blocks taken from the heap since the thread started */
+};
+
+void png2pos_arena_stats(struct png2pos_arena_stats *stats);
+
+/* a job for the lifetime of the object, so that it ends however the
+   scope is left */
+struct png2pos_arena_job {
+  png2pos_arena_job() {
+    png2pos_arena_begin();
+  }
+  ~png2pos_arena_job() {
+    png2pos_arena_end();
+  }
+  png2pos_arena_job(const png2pos_arena_job &) = delete;
+  png2pos_arena_job &operator=(const png2pos_arena_job &) = delete;
+};
+
+#endif /* PNG2POS_ARENA_H */
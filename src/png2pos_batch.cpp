@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include "lodepng.h"
+#include "png2pos_batch.h"
+
+/* the loaded file and the output file are released however the job ends,
+   also when the converter throws */
+struct s_free {
+  void operator()(unsigned char *p) const { free(p); }
+};
+
+struct s_fclose {
+  void operator()(FILE *f) const { fclose(f); }
+};
+
+static void s_run_job(struct png2pos_job *job,
+                      const struct png2pos_options *opt) {
+  const unsigned char *png = job->png;
+  size_t png_size = job->png_size;
+  std::unique_ptr<unsigned char, s_free> loaded;
+
+  if (!png) {
+    unsigned char *data = NULL;
+    job->error = lodepng_load_file(&data, &png_size, job->path.c_str());
+    loaded.reset(data);
+    if (job->error) {
+      return;
+    }
+    png = data;
+  }
+
+  struct png2pos_sink sink;
+  std::unique_ptr<FILE, s_fclose> fout;
+
+  if (job->out_path.empty()) {
+    png2pos_sink_buffer(&sink, &job->out);
+  } else {
+    /* bands go to the descriptor straight from the converter's bitmap,
+       the stdio buffer is never used */
+    fout.reset(fopen(job->out_path.c_str(), "wb"));
+    if (!fout) {
+      job->error = 1;
+      return;
+    }
+    png2pos_sink_fd(&sink, fileno(fout.get()));
+  }
+
+  job->error = png2pos_convert(png, png_size, opt, &sink, &job->stats);
+  job->error |= png2pos_sink_flush(&sink);
+
+  if (fout) {
+    job->error |= fclose(fout.release()) != 0;
+  }
+}
+
+static void s_worker(struct png2pos_job *jobs, size_t n,
+                     const struct png2pos_options *opt,
+                     std::atomic<size_t> *next) {
+  for (size_t i; (i = next->fetch_add(1)) < n; ) {
+    /* out of memory growing a stream, or no thread for the dithering of
+       an image; the caller reports it once every worker has returned */
+    try {
+      s_run_job(&jobs[i], opt);
+    } catch (const std::exception &e) {
+      jobs[i].error = 1;
+      jobs[i].failure = e.what();
+    } catch (...) {
+      jobs[i].error = 1;
+      jobs[i].failure = "unknown error";
+    }
+  }
+}
+
+void png2pos_convert_batch(struct png2pos_job *jobs, size_t n,
+                           const struct png2pos_options *opt,
+                           unsigned int workers) {
+  std::atomic<size_t> next(0);
+
+  if (workers > n) {
+    workers = n;
+  }
+
+  /* with fewer threads than asked for the workers that did start take
+     all jobs */
+  std::vector<std::thread> pool;
+  pool.reserve(workers);
+  try {
+    for (unsigned int t = 1; t < workers; ++t) {
+      pool.push_back(std::thread(s_worker, jobs, n, opt, &next));
+    }
+  } catch (const std::system_error &) {
+  }
+  s_worker(jobs, n, opt, &next);
+  for (unsigned int t = 0; t != pool.size(); ++t) {
+    pool[t].join();
+  }
+}
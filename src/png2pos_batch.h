@@ -0,0 +1,33 @@
+/* png2pos_batch.h, converting many PNG images on a pool of worker threads */
+
+#ifndef PNG2POS_BATCH_H
+#define PNG2POS_BATCH_H
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include "png2pos_convert.h"
+
+/* one image of a batch: either PNG data in memory (png, png_size) or, when
+   png is NULL, the path of a PNG file which the worker loads itself; the
+   stream is collected in out, or written to the file out_path if set */
+struct png2pos_job {
+  const unsigned char *png;
+  size_t png_size;
+  std::string path;
+  std::string out_path;
+  std::vector<unsigned char> out; /* ESC/POS stream */
+  unsigned int error; /* as returned by png2pos_convert(), or 1 */
+  std::string failure; /* what() of an exception the conversion threw */
+  struct png2pos_stats stats;
+};
+
+/* convert all jobs with the same options on up to workers threads; every
+   worker takes the next unconverted job until none is left; an exception
+   thrown by a conversion fails only its job (error and failure are set)
+   and never leaves a worker */
+void png2pos_convert_batch(struct png2pos_job *jobs, size_t n,
+                           const struct png2pos_options *opt,
+                           unsigned int workers);
+
+#endif /* PNG2POS_BATCH_H */
@@ -0,0 +1,399 @@
+/* png2pos_bluenoise.h, 64×64 blue noise threshold mask
+
+   Generated once with the void-and-cluster method (R. Ulichney, "The
+   void-and-cluster method for dither array generation", 1993) on a
+   toroidal 64×64 grid, Gaussian filter sigma = 1.5, 10 % initial binary
+   pattern; entry = rank * 255 / 4096, so each of the levels 0..254 is
+   used 16 times. */
+
+#ifndef PNG2POS_BLUENOISE_H
+#define PNG2POS_BLUENOISE_H
+
+static const unsigned char bluenoise_mask[64][64] = {
+  {
+    207,  12, 189, 218,  90,  58, 122, 232,  37, 154,  60, 124,  47,  15, 212, 111,
+    224, 123, 235,  53, 171,  73,  34, 139, 191,  65, 230, 124, 172, 246,  39, 207,
+     88, 251,  73, 186,  27, 223, 137, 245, 106,  20, 229,  89, 217,  63,   4, 230,
+    123,  16,  95, 224,  59, 186,  81, 234,  63, 193, 109, 145, 175, 132,  61, 109
+  },
+  {
+     37, 130,  70, 141,   2, 161, 202,  73, 169, 217,  91, 250, 197,  97, 154,  55,
+    167,   0, 145,  96, 201, 128, 105, 167, 243,  97,  41,  10,  69, 107, 191,  58,
+    134,  19, 220,  98, 160,  56,  92,  33,  72, 147, 122, 176,  37, 142, 209, 163,
+     56, 149, 204, 166, 138, 241,  30, 115, 177,  19, 245,  31, 210,  10, 253, 163
+  },
+  {
+    225, 102, 172, 244,  39, 222, 136,  24, 109,   4, 178,  31, 146,  76, 238,  34,
+    201,  85, 188,  29, 249,  13, 221,  54,  22, 152, 215, 183, 225, 145,  14, 230,
+    155, 111, 171,   7, 239, 116, 211, 190, 166, 214,   5,  67, 252, 114,  87,  34,
+    106, 233,  74,   1,  89,  46, 159, 209, 140,  51, 162,  71,  97, 120, 187,  76
+  },
+  {
+    201,  16,  57, 193, 118,  99,  54, 187, 228, 142,  71, 115, 217,   7, 175, 106,
+    134, 243,  46, 164,  65, 148, 184,  83, 200, 111,  74, 130,  49,  90, 167,  77,
+     33, 214,  51, 203, 143,  78,  20, 124,  49, 240, 101, 194, 159,  17, 181, 243,
+    195,  22, 179, 119, 198, 219, 103,  12,  77, 229, 124, 197, 223,  55,  28, 147
+  },
+  {
+     48, 232, 153,  77,  23, 175, 250,  87,  44, 195, 241,  51, 189, 127,  62, 223,
+     16,  73, 119, 229,  89, 114,  42, 233, 136,   1, 175, 250,  23, 211, 117, 242,
+    182,  93, 128,  69,  37, 175, 253, 152,  91,  27, 139,  41,  80, 222,  52, 131,
+     71, 140,  48, 245,  27, 133,  64, 246, 191,  92,   3,  39, 144, 172, 241,  93
+  },
+  {
+    181, 106, 126, 238, 209, 143,   9, 163, 121,  17,  98, 165,  21, 245,  90, 155,
+    182, 203, 144,   9, 178, 207,  25, 163,  59, 211,  38, 159, 104, 185,   4,  52,
+    143,  20, 247, 190, 106, 216,   1,  62, 202, 177, 234, 119, 201, 147, 103,   5,
+    170, 221, 105, 157,  80, 185, 165,  40, 114, 155, 178, 250,  80, 109,   6, 135
+  },
+  {
+     31, 216,  11,  45,  94,  62, 217,  74, 235, 137, 206,  79, 149,  43, 209,  26,
+     56,  97,  36, 216,  55, 129, 253, 104,  86, 239, 123,  81,  60, 232, 133, 201,
+     72, 219, 152,  14, 164,  82, 132, 228, 114,  75,   8, 165,  58,  29, 232, 208,
+     91,  33, 196,  60, 233,   6, 122, 223,  21, 216,  50, 131,  25, 220, 198,  70
+  },
+  {
+    167,  84, 187, 156, 199, 129,  33, 105, 182,  57,  34, 232, 104, 186, 115, 139,
+    249, 168, 236, 108, 156,  76,   5, 195, 145,  22, 180, 202, 148,  32,  84, 164,
+    103,  41, 118,  60, 238,  44, 192,  29, 160,  47, 214,  98, 248, 175, 138,  65,
+    125, 250,  15, 144,  93, 202,  50,  85, 145,  69, 101, 207, 183,  59, 151, 237
+  },
+  {
+    130,  56, 252, 110,  18, 172, 246, 148,   0, 221, 171, 130,   8,  63, 227,  82,
+      2, 126,  65,  17, 190, 228, 175,  40, 223, 110,  53,   8, 225, 114, 253,  14,
+    209, 175, 227,  90, 202, 112, 148,  92, 245, 187, 134,  21,  80, 113,  12, 183,
+     42, 162, 111, 179,  37, 135, 253, 168, 188, 241,  13, 161,  83, 118,  15,  95
+  },
+  {
+    226,   2, 138,  67, 231,  82,  50, 194,  89, 115,  75, 197, 254, 159,  31, 176,
+    214,  89, 197, 148,  47,  95, 123,  63, 159,  77, 213, 136, 170,  49, 186,  62,
+    139,  28, 130,   6, 159,  22, 225,  60,  10, 107, 153, 224, 195,  48, 238, 201,
+     86, 224,  73, 206, 229, 102,  64,  10, 111,  43, 125, 227,  33, 247, 173,  43
+  },
+  {
+    107, 183, 205,  36, 149, 215, 119,  27, 239, 162,  20,  47,  92, 119, 195,  52,
+    144,  39, 224, 114, 244,  27, 143, 236,  12, 188, 248,  91,  29, 100, 153, 215,
+     88, 241,  69, 184, 251,  76, 131, 170, 216,  77,  36,  64, 121, 163,  99, 145,
+     18, 130,  51,   2, 155,  27, 194, 141, 217,  89, 202, 148,  57, 197, 139, 211
+  },
+  {
+    154,  28,  86, 168, 104,  10, 180, 140,  62, 204, 132, 218, 147,  17,  78, 235,
+    102, 170,  21,  77, 160, 210,  84, 199, 117,  34, 126,  66, 204, 238,   1, 119,
+     43, 192, 108, 145,  36, 102, 201,  42, 115, 192, 252, 171,   1, 229,  35,  67,
+    211, 177, 244,  88, 118, 173,  80, 237,  30, 178,  68,   0, 112,  87,  23,  72
+  },
+  {
+     53, 246, 122, 220,  54, 200,  77, 230, 103,  38, 184,  68, 241, 174, 210, 128,
+      7, 249, 136, 186,  59,   0, 170,  45,  98, 176, 151,  16, 179, 135,  79, 229,
+    170,  12, 223,  56, 214, 176,   3, 240, 157,  18,  94, 138, 206,  84, 154, 250,
+    112,  32, 143, 195, 232,  45, 207, 107,  55, 129, 250, 157, 230, 177, 123, 235
+  },
+  {
+    102, 174,   7,  73, 237, 131,  42, 156,  16, 248, 113,   4,  99,  56,  30, 161,
+     64, 203,  42, 108, 217, 127, 251,  70, 206, 241,  52, 225, 112,  37, 195,  59,
+    129,  91, 158,  23, 125,  65, 143,  85,  51, 130, 221,  24,  59, 185, 128,   8,
+    169,  57, 101,  17,  64, 135,   6, 153, 171,  23, 191,  79,  44, 214,  13, 191
+  },
+  {
+     34, 210, 140, 159,  25, 178,  93, 214, 174,  83, 144, 164, 200, 136, 231, 114,
+     93, 180,  82, 233,  18,  93, 150,  25, 132,   5,  87, 165,  70, 251, 154,  18,
+    208, 247,  73, 191, 243,  99, 227, 183, 204,  70, 177, 111, 242,  42, 100, 223,
+     82, 204, 237, 161, 186, 220,  75, 244,  94, 221, 116,  16, 102, 134,  61, 148
+  },
+  {
+    226,  92,  50, 196, 105, 252,   2, 119,  58, 220,  43, 237,  25,  82, 185,  45,
+    240,  13, 134, 157, 200,  53, 179, 213, 107, 190, 144, 216,  20,  93, 185, 107,
+     35, 144, 116,  46, 168,  18,  39, 108,   9, 247,  33, 142,  77, 200, 157,  30,
+    188, 118,  38,  78, 109,  29, 121, 197,  41,  66, 144, 239, 205, 169, 254,  78
+  },
+  {
+    129,  19, 117, 219,  36,  68, 149, 199,  29, 134, 185,  66, 108, 222,   8, 146,
+    209, 165,  35,  69, 118, 238,  34,  80, 227,  61,  35, 123, 201,  49, 136, 232,
+     64, 182,   6, 233,  82, 132, 216, 165, 124, 151,  89, 218, 170,  11, 234,  68,
+    139,  12, 218, 150, 253,  56, 181, 140,   9, 213, 179,  32,  54,  89,   3, 185
+  },
+  {
+    161, 245,  75, 181, 133, 228, 171,  76, 235,  92,   9, 123, 203, 154,  59, 124,
+     75, 102, 252, 182,  22,  99, 167, 135,  10, 160, 237, 102, 171, 242,   3,  84,
+    161, 221,  98, 205, 149, 196,  55,  77, 229,  45, 184,  20, 120,  58, 132, 103,
+    247, 163,  52, 130,   1, 162,  90, 228, 111, 161,  79, 127, 196, 158, 114,  43
+  },
+  {
+     64, 200, 148,   5,  97,  53,  15, 106, 143, 210, 168, 253,  30,  95, 173, 227,
+     18, 190,  49, 128, 221, 195,  58, 246, 112, 185,  83,  13,  66, 150, 113, 210,
+     27, 120,  43,  69,  13, 106, 254,  23, 102, 203,  65, 240,  95, 212, 187,  37,
+    179,  85, 202,  98, 188, 211,  22,  73,  47, 250,  19, 104, 237,  27, 228, 208
+  },
+  {
+     15, 107,  40, 232, 162, 211, 186, 246,  47,  20,  71, 140,  51, 191, 243,  40,
+    113, 214,  86, 154,   2,  75, 142,  21, 205,  51, 145, 197, 220,  36, 187,  57,
+    173, 139, 236, 160, 182,  37, 145, 189, 167,   0, 133, 160,  40, 147,   5, 225,
+     63,  22, 240,  35,  64, 116, 239, 154, 191, 132, 203,  58, 150,  76, 138,  93
+  },
+  {
+    239, 135, 190,  60, 119,  86,  32, 125, 159, 192, 109, 225,  86,   2, 134,  72,
+    167, 140,  28, 229, 108, 163, 213,  97,  37, 129, 254,  24, 118,  76, 228,  96,
+    251,  11,  80, 210, 119, 227,  60, 127,  81, 234, 107, 208,  79, 252, 115,  92,
+    152, 128, 107, 176, 222, 142,  43, 105,   4,  88, 173, 219,  14, 190,  49, 170
+  },
+  {
+     31,  79, 168, 251,  20, 146, 224,  61,  91, 236,  38, 177, 213, 159, 106, 208,
+     12, 248,  63, 194,  38, 242,  53, 178, 231,  78, 169,  96, 181, 142,  17, 128,
+     41, 195, 104,  52,  19,  88, 196,  13, 214,  53,  32, 177,  16, 191,  51, 173,
+    205, 231,   6, 157,  80,  24, 199, 165, 230,  68,  35, 121, 100, 249, 126, 211
+  },
+  {
+    113, 221,   8, 100, 204,  76, 172,   0, 209, 137,  13, 121,  66,  27, 238,  53,
+    186,  96, 124, 174,  84, 132,  15, 109, 150,   3,  60, 211,  46, 244, 160, 202,
+     73, 150, 180, 245, 137, 158, 236, 100, 152, 120, 243, 144,  62, 129, 217,  19,
+     40,  71, 192,  52, 134, 248,  92,  54, 206, 143, 243, 157,  43, 177,   1,  66
+  },
+  {
+    187, 146,  54, 127, 159,  47, 242, 105, 180,  80,  54, 249, 142, 173,  88, 130,
+    154,  36, 234,   7, 151, 203,  68, 223, 189, 120, 238, 136,  10,  88,  59, 108,
+    217,   2, 122,  33, 213,  72,  45, 175,  27, 187,  74,  97, 229, 158, 103,  81,
+    144, 117, 244,  99, 212,  16, 184, 128,  29, 110,   9, 194,  80, 227,  96, 158
+  },
+  {
+     40,  88, 243, 193,  24, 217, 131,  37, 149, 231, 204,  94, 194,  43, 229,  19,
+    202,  77, 215,  56, 113, 247, 167,  27,  86,  42, 198, 104, 166, 188, 235,  22,
+    169, 230,  65,  93, 170,   5, 128, 248,  59, 223,  18, 201,  41,   2, 245, 193,
+    224, 160,  11, 179,  43, 117, 158,  70, 237, 172,  93, 216,  57, 140,  26, 238
+  },
+  {
+    198,  12, 171,  71, 116,  90, 187,  68,  17, 115,  30, 158,   6, 109, 211,  67,
+    117, 163,  98, 181,  21,  80,  46, 142, 212, 162,  72,  26, 219, 124,  37, 145,
+     86,  44, 133, 193, 234, 110, 207,  83, 141, 104, 164, 123, 180,  69, 115,  49,
+     28,  92,  63, 137, 225,  85, 195,  11, 210,  48, 136,  32, 114, 168, 206, 123
+  },
+  {
+    105, 140, 220,  35, 236,  14, 155, 254, 201, 172,  71, 129, 243,  79, 140, 178,
+      3, 250,  32, 131, 229, 193, 125, 233, 101,  12, 248, 140,  50,  78, 212, 114,
+    241, 201, 154,  21,  51, 147,  36, 182,   9, 213,  49, 251,  87, 212, 169, 135,
+    184, 208, 239, 166,  29,  58, 254,  99, 151,  78, 226, 181, 251,  16,  76,  50
+  },
+  {
+    247,  61,  86, 162, 134, 206,  55, 124,  85,  45, 226, 185,  50, 165,  31, 235,
+     55, 146, 206,  63, 155,  94,   1, 179,  54, 121, 186,  91, 236, 156,  10, 175,
+     68,  14,  99, 252,  74, 190,  96, 231, 159,  78, 136,  12, 149,  32, 228,  10,
+     78, 124,  18, 104, 199, 126, 143,  40, 177, 120,   2,  65, 151, 102, 218, 176
+  },
+  {
+    156,  27, 212, 110,  46, 180, 101,   3, 218, 142, 103,  11, 214, 121, 198, 101,
+     82, 184, 107,  17, 219,  41, 251,  74, 149, 224,  39, 168,  20, 200,  97,  54,
+    188, 127, 219, 163, 117, 215,  23,  63, 121,  34, 235, 191, 113,  63,  99, 158,
+    252,  53, 152,  75, 235,   5, 186, 215,  22, 244, 196,  90, 204,  45, 130,   4
+  },
+  {
+    234, 117, 194,   8, 245,  79, 231, 163, 188,  25, 248, 153,  91,  65,  24, 220,
+    130,  37, 238,  74, 174, 138, 111, 199,  28,  83, 206, 110,  66, 125, 225, 147,
+    245,  31,  81,  46,  10, 173, 139, 249, 179, 207,  91,  54, 161, 240, 197,  42,
+    112, 186, 220,  38, 172, 114,  65,  86, 109,  54, 163, 126,  18, 227, 185,  94
+  },
+  {
+    144,  47, 165,  67, 151,  23, 138,  40,  67, 121,  78,  38, 182, 240, 149, 171,
+     10, 194, 159, 123, 203,  56,  16, 160, 238, 131,   5, 152, 251, 174,  42,   0,
+    111, 167, 206, 132, 239,  71, 103,  48,   1, 108, 167,  23, 215,  14, 136,  83,
+    213,   0, 131,  96, 207,  48, 241, 165, 224, 141,  34, 234,  60, 148,  78,  31
+  },
+  {
+     71, 217,  98, 226, 189,  91, 210, 108, 201, 232, 165, 209, 132,  15, 112,  52,
+    253,  96,  47,   6,  87, 243, 189,  95,  63, 177, 220,  59,  30,  88, 198,  70,
+    216,  94,  58, 152, 193,  29, 223, 201, 150,  66, 226, 139,  73, 117, 180,  29,
+    165,  66, 246,  23, 157, 138,  26, 199,   7,  72, 190,  97, 174, 110, 253, 202
+  },
+  {
+    171,  16, 134,  35, 122,  55, 250,  15, 149,  50,   5, 106,  60, 222,  87, 205,
+     73, 141, 210, 232, 153, 116,  35, 217, 120,  44, 101, 191, 134, 235, 116, 142,
+    181,  24, 233,   6,  85, 121, 164,  82, 127, 243,  41, 195,  97, 244,  50, 232,
+    145, 108, 178,  85, 230,  71, 124,  94, 155, 115, 246,  22, 210,  43,  11, 125
+  },
+  {
+    242,  83, 178, 237,   1, 167, 132,  72, 180,  96, 193, 246, 146,  32, 186, 157,
+     17, 179, 110,  67,  25, 174,  79, 145,  10, 156, 240,  78,  11, 166,  22, 223,
+     46, 125, 199, 109, 178, 247,  44,  12, 188,  26, 116, 173,   4, 152, 202,  91,
+     12, 224,  40, 202,  14, 185, 249,  35, 218,  48, 168,  83, 131, 154, 193,  56
+  },
+  {
+    151,  44, 199,  64, 100, 219, 196,  32, 236, 130,  23,  82, 169, 117, 230,  44,
+    128, 218,  35, 137, 193, 222,  52, 252, 183, 205,  33, 140, 215, 106,  62,  84,
+    155, 254,  70,  39, 146,  62, 204, 101, 157, 214,  86,  61, 220,  36,  69, 125,
+    172,  62, 141, 121,  53, 108, 169,  61, 193, 128,   9, 222,  62, 236,  92, 114
+  },
+  {
+     28, 223, 111, 158, 137,  46,  82, 116, 157,  61, 221,  46, 203,   0,  69, 103,
+    246,  58,  90, 239,   2, 101, 123,  27,  90,  69, 112, 174,  53, 194, 240, 177,
+      4,  99, 168, 217,  15, 226, 139,  73, 237,  50, 143, 251, 129, 100, 189, 248,
+     32, 197,  87, 218, 151, 227,   2, 141,  82, 241, 102, 188,  33, 166,   4, 215
+  },
+  {
+    176,  88,  12, 252,  22, 183, 240,   7, 208, 102, 183, 135,  94, 238, 142, 174,
+     11, 153, 199, 170,  74, 152, 209, 168, 133, 226,   4, 249,  94,  35, 143, 117,
+    207,  31, 131, 191,  88, 113,  21, 184, 123,   7, 176,  23, 205, 161,  19, 145,
+    110, 235,   5, 176,  31,  72,  98, 209,  25, 158,  68, 146, 116, 205,  75, 141
+  },
+  {
+     60, 126, 194,  74, 213,  95, 149,  55, 174,  17, 249,  31, 162,  55, 193,  79,
+    212, 118,  28, 127,  44, 229,  17,  61, 198,  39, 189, 156, 125,  16, 230,  47,
+     77, 242,  60, 155,  48, 235, 170,  38, 212,  91, 196, 110,  76,  54, 227,  84,
+     50, 162,  67, 104, 253, 189, 128, 233, 177,  44, 218,  17, 252,  47, 104, 243
+  },
+  {
+     39, 229, 143,  49, 161,  29, 125, 230,  88, 141,  75, 119, 219,  18, 125,  32,
+    231,  97,  68, 248, 177,  87, 116, 243,  99, 146,  56,  78, 219, 172,  90, 199,
+    166, 111, 221,   7, 126, 199,  70, 104, 246,  60, 148,  42, 240, 122, 178,  11,
+    204, 118, 192, 138,  45, 160,  16,  57,  87, 119, 197,  93, 132, 181,  21, 198
+  },
+  {
+    166,   8,  99, 180, 112, 242,  66, 197,  41, 214, 171,  59, 199, 106, 253, 160,
+     49, 184, 207,  20, 136, 193,  35, 160,  11, 231, 120,  25, 196,  62, 131,   9,
+    147,  26, 179, 100, 250,  28, 140, 159,  15, 125, 224, 170,   4, 214,  95, 152,
+    246,  34, 217,  19,  91, 204, 113, 152, 248,   8, 168,  60, 228,  82, 148, 114
+  },
+  {
+    219,  79, 246,  34, 205,   3, 169, 101,  23, 112, 239,   4, 147,  82, 182,  67,
+    135,   6, 151, 108,  55, 215,  75, 127, 212,  84, 165, 242, 107,  38, 248, 216,
+     55,  87, 206,  66, 162,  83, 214,  52, 183, 207,  28,  83, 137, 192,  35,  70,
+    133,  98,  61, 168, 242,  71, 224,  37, 188, 135, 221,  36, 162,   0, 239,  63
+  },
+  {
+    131, 201, 150,  64, 129,  83, 222, 138, 188, 153,  48,  96, 229,  40,  13, 215,
+    112, 241,  81, 228, 167,   4, 254, 178,  62,  42, 187,   2, 140, 160,  96, 184,
+    117, 240, 136,  38, 189, 115,   9, 240,  88, 112,  64, 253, 103,  58, 163, 223,
+     22, 184, 232, 121, 144,  11, 174,  64, 100,  24,  75, 114, 206, 102, 191,  28
+  },
+  {
+     44, 109,  14, 185, 233, 157,  55,  15, 252,  70, 209, 173, 122, 192, 154,  94,
+    177,  43, 199,  30,  92, 147, 103,  24, 203, 149,  94, 222,  74, 210,  14,  67,
+     35, 167,   1, 230,  57, 219, 132, 170,  38, 149, 200, 160,  20, 234, 116, 196,
+     81, 150,   0,  47,  86, 197, 110, 141, 241, 200, 155, 237,  52, 139,  77, 158
+  },
+  {
+    175,  84, 219,  47,  98,  27, 200, 124,  92,  33, 133,  14,  72, 244,  57, 223,
+     21, 144,  65, 124, 192, 236,  51, 138, 113, 233,  32, 122,  51, 174, 129, 236,
+    150, 198,  79, 105, 153,  24,  92,  65, 228,   2, 123,  47, 182, 141,   7,  49,
+    250, 105, 207, 178, 222,  31,  54, 218,   5,  84, 125,  26, 182,  12, 243, 213
+  },
+  {
+     19, 254, 140, 166, 121, 240,  73, 176, 217, 160, 233, 197, 105,  27, 141, 116,
+     83, 251, 159, 217,  14,  74, 171, 219,   8,  68, 166, 195, 251,  26,  84, 216,
+    101,  21, 252, 127, 204, 181, 247, 138, 178, 209,  94, 239,  75, 216,  95, 176,
+    129,  29,  72, 117, 155, 252, 129, 183, 158,  44, 176,  67, 222,  94, 120,  60
+  },
+  {
+    194, 115,  68,   5, 209,  42, 144, 103,   0,  59,  85,  39, 165, 212, 180,  48,
+    197,   1, 106,  45, 180, 118,  34,  84, 186, 243, 101,  15, 150, 111, 181,  44,
+    141,  63, 176,  30,  49,  76,  11, 111,  33,  59, 164,  24, 112,  39, 202,  63,
+    220, 164, 233,  14,  57,  99,  21,  70,  96, 205, 249, 106, 151, 204,  32, 146
+  },
+  {
+     97,  36, 179, 230,  90, 191,  20, 246, 194, 117, 147, 249, 127,  79,  13, 237,
+    131, 173, 228,  89, 139, 245, 207, 156, 127,  39, 141,  81, 208,  59, 230,  13,
+    194, 118, 213, 160,  95, 230, 147, 216,  83, 244, 126, 187, 225, 153, 121,  11,
+    143,  43,  87, 175, 196, 142, 211, 239, 120,  30, 136,   3,  46,  80, 170, 234
+  },
+  {
+     71, 207, 124,  57, 149, 112,  69, 163,  45, 221, 177,  10,  56, 229,  97, 153,
+     61,  30,  72, 192,  17,  54, 100,  13, 227,  58, 215, 175,  29, 133, 156,  95,
+    244,  81,   4, 237, 112, 194,  40, 162, 192,   7, 148,  67,  17,  81, 167, 247,
+    100, 205, 119, 242,  74,  41, 168,   8, 187,  61, 231, 166, 198, 245, 130,   8
+  },
+  {
+    225, 159,  14, 249,  30, 173, 229, 129,  94,  29,  72, 103, 192, 161,  37, 200,
+    120, 247, 157, 113, 222, 146, 198,  72, 115, 162,   0, 105, 241,  75, 212,  51,
+    164,  36, 147,  55, 135,  15,  68, 122, 100,  54, 232, 105, 205, 237,  33, 190,
+     70,  24, 153,   5, 135, 228, 110,  81, 145, 214,  89, 115,  66,  26, 103, 183
+  },
+  {
+     39,  89, 135, 193,  79, 208,  13,  58, 199, 143, 239, 210, 137,  23, 110, 224,
+     84,   9, 208,  36,  65, 175,  26, 250, 184,  85, 234, 189,  41, 119,   7, 190,
+    127, 226, 186,  85, 209, 169, 220, 253,  26, 209, 166,  42, 138,  93,  57, 114,
+    226, 182,  52, 213, 100,  26, 200,  48, 164,  16,  40, 192, 153, 222,  51, 145
+  },
+  {
+    236,  64, 218, 109,  48, 137, 102, 242, 156,   7, 119,  40,  84, 254, 187,  49,
+    144, 179,  98, 135, 242,  89, 126,  41, 148,  21, 131,  64, 150, 172, 254, 100,
+     25,  69, 106, 248,  28,  47,  90, 143, 181,  80, 132,  10, 195, 175, 149,   2,
+    134,  85, 254, 171,  66, 151, 243, 129, 224, 105, 253, 130,  11,  83, 204, 118
+  },
+  {
+    188,  29, 176,  20, 162, 226, 183,  37,  81, 218, 180,  63, 164,   3, 129,  74,
+     19, 221,  53, 188,   5, 159, 215, 107, 227,  51, 199,  93, 221,  28,  83, 144,
+    211, 174,   6, 152, 126, 187, 113,   1,  61, 228, 108, 245,  74,  25, 231, 211,
+    164,  34, 108, 127,  42, 179,  87,  22,  70, 183,  57, 169, 234, 109, 163,   1
+  },
+  {
+     98, 151, 122, 244,  91,   4,  66, 116, 169,  25, 105, 203, 235,  95, 211, 174,
+    245, 157, 122,  79, 231,  24,  61, 196,  79, 172, 247,  18, 113, 201,  60, 230,
+     47, 117, 203,  62, 226,  73, 238, 200, 156,  28, 173,  46, 206, 122, 100,  44,
+     76, 197,  15, 207, 233,   1, 194, 118, 211, 150,  95,  27, 195,  38,  67, 249
+  },
+  {
+     45, 203,  75,  53, 213, 150, 200, 251, 133, 233,  48, 142,  30, 154,  56, 111,
+     38,  92,  25, 203, 139, 102, 180,  31, 141,   4, 124, 161,  44, 176, 130,   9,
+    161, 240,  92,  39, 164,  14, 135,  41,  98, 213, 128,  88, 155,  61, 250, 185,
+    130, 237, 156,  71,  95, 142,  56, 247,  43,   7, 238, 123,  80, 142, 214, 126
+  },
+  {
+     87, 224,   9, 184, 127,  31,  99,  51,  15,  89, 187,  74, 122, 191,  18, 217,
+    137, 193, 241,  48, 169,  74, 253, 115, 213,  95,  57, 236,  78, 225,  97, 193,
+     72,  19, 136, 189, 107, 210,  85, 178, 249,  66,   6, 236, 181,  20, 146,   9,
+     96,  59,  30, 182, 120, 221, 158, 101, 172, 133, 201,  49, 226, 182,  20, 171
+  },
+  {
+     32, 134, 161, 104, 236,  78, 182, 163, 208, 146, 223,   6, 249,  90, 231,  75,
+    167,   1,  69, 111, 219,   8, 154,  46, 233, 183, 150, 205,  11, 146,  33, 244,
+    110, 151, 218,  26, 247,  52, 152,  18, 118, 148, 190,  39, 111, 220,  81, 212,
+    172, 225, 146, 248,  46,  16,  80,  30, 191,  64,  89, 162,  10,  99,  61, 234
+  },
+  {
+    196,  67, 254,  43, 148,  19, 228, 111,  68,  39, 117, 173,  59, 158, 126,  46,
+    104, 234, 152, 184,  36, 132, 208,  86,  19,  71,  30, 102, 121, 189,  63, 167,
+    208,  53,  85, 172,  71, 127, 225, 198,  49,  78, 226, 133,  57, 164,  31, 126,
+     48, 114,   7,  89, 195, 166, 210, 237, 113, 222,  26, 251, 137, 204, 150, 115
+  },
+  {
+    166,  96,  14, 189,  63, 212, 132,   0, 244, 156,  98, 212,  33, 203,  10, 180,
+    206,  31, 125,  89, 242,  64, 192, 122, 169, 137, 197, 250,  51, 220,  87,   5,
+    131,  34, 226, 120,   3, 185,  34, 101, 164, 210,  25,  90, 245, 188, 101, 239,
+    192,  75, 207, 138,  65, 103, 135,  58,   3, 151, 181, 105,  70,  38, 242,   3
+  },
+  {
+    222, 138, 207, 124,  93, 169,  46,  86, 188,  25, 231,  77, 140, 108, 244, 147,
+     87,  62, 223,  17, 166, 103,  13, 246,  56, 224,  88, 165,  18, 139, 181, 104,
+    252, 156, 196, 100, 240, 146,  82, 235,   8, 115, 179, 155,   0,  69, 142,  15,
+    154,  35, 173, 221,  21, 244,  38, 183, 125,  81,  44, 211, 128, 190,  90,  53
+  },
+  {
+    180,  40,  81, 225,  23, 246, 152, 203, 120,  58, 170,  17, 190,  50,  72,  26,
+    236, 138, 190,  48, 215, 143,  40, 181, 109,   2,  41, 127,  71, 233,  45, 202,
+     76,  16,  67,  41, 165,  57, 202, 136,  67, 254,  52, 104, 198, 232,  45, 209,
+     92, 250, 106,  53, 121, 191, 153,  90, 205, 241, 166,  13, 231,  24, 155, 110
+  },
+  {
+    248,  19, 157,  56, 183, 112,  69,  31, 227, 137,  91, 253, 120, 216, 168, 198,
+    106,   6, 162, 116,  68, 198, 234,  77, 158, 212, 187, 239, 107, 171,  28, 147,
+    122, 231, 185, 133, 213,  15, 116,  32, 190, 145, 218,  33, 136,  81, 119, 177,
+     62, 133,   3, 161, 228,  73,  12, 232,  24,  55, 141, 101,  65, 173, 216,  73
+  },
+  {
+    118, 200,  97, 234, 134,   7, 215, 105, 163,   8, 184,  42, 153,   3,  93, 128,
+     52, 218,  84, 251,  24,  94, 123,  21, 133,  62,  96, 149,   9, 194,  93, 215,
+     52, 164,  82,  22,  98, 248, 169, 227,  95,  12,  76, 171, 206,  13, 161, 227,
+     23, 216, 196,  88,  33, 139,  99, 170, 119,  77, 189, 249, 123,  41, 137,   8
+  },
+  {
+     55, 139, 175,  28,  76, 195, 148,  50, 242,  77, 208, 107,  70, 232,  37, 247,
+    151, 178,  36, 137, 186, 154,  50, 220, 175, 254,  29,  54, 222, 133,  66, 238,
+      0, 108, 204, 235, 153,  65,  86,  45, 155, 126, 239, 109,  50, 247,  97,  38,
+    110, 147,  68, 174, 208, 254,  49, 198, 219,  34, 159,   0, 202,  96, 185, 223
+  },
+  {
+     85, 241,  45, 113, 168, 252,  19,  95, 189, 131,  21, 225, 172, 134, 184,  80,
+     20,  69, 206, 107,   9, 238, 205,  86,   6, 113, 157, 200,  85,  22, 158, 118,
+    179,  36, 143,  47, 120, 196,   3, 176, 208,  58, 186,  25, 156, 128, 192,  76,
+    182, 245,  42, 126,  18, 109, 155,   6, 134,  91, 226,  50,  79, 235,  26, 156
+  }
+};
+
+#endif /* PNG2POS_BLUENOISE_H */
@@ -0,0 +1,743 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "lodepng.h"
+#include "png2pos_arena.h"
+#include "png2pos_convert.h"
+#include "png2pos_grey.h"
+#include "png2pos_pack.h"
+#include "png2pos_profile.h"
+#include "png2pos_scale.h"
+#include "png2pos_tone.h"
+
+#ifdef LODEPNG_NO_COMPILE_ALLOCATORS
+/* modified lodepng allocators: while a conversion runs on the thread the
+   decoder allocates from its scratch arena; the memory is not cleared,
+   lodepng writes every byte it reads back */
+
+void *lodepng_malloc(size_t size) {
+    return png2pos_arena_alloc(size);
+}
+
+void *lodepng_realloc(void *ptr, size_t new_size) {
+    return png2pos_arena_realloc(ptr, new_size);
+}
+
+void lodepng_free(void *ptr) {
+    png2pos_arena_free(ptr);
+}
+#endif
+
+/* decode a PNG straight to an L* plane of w * h bytes (in *grey, from the
+   arena) and count it into histogram; only true colour images are
+   expanded to RGBA, grey and palette images are decoded as they are
+   stored: 8 bit grey levels already are L*, palette indexes and 1 - 4 bit
+   levels are looked up in a table of L* values, 16 bit levels keep their
+   high byte and grey with alpha is composited on two bytes a pixel;
+   if *bits is set on entry, a 1 bit grey or palette image is left as it
+   is decoded instead (rows not padded, no histogram) with the L* of its
+   two values in levels, and *bits stays set; returns a lodepng error */
+static unsigned int s_decode_grey(const unsigned char *png, size_t png_size,
+                                  unsigned char background,
+                                  unsigned char **grey, unsigned int *w,
+                                  unsigned int *h,
+                                  unsigned int histogram[256],
+                                  unsigned int *bits,
+                                  unsigned char levels[2]) {
+  LodePNGState state;
+  unsigned char *raw = NULL;
+  const unsigned int keep_bits = *bits;
+
+  *grey = NULL;
+  *bits = 0;
+  lodepng_state_init(&state);
+
+  /* the colour type is in the header, PLTE and tRNS come with the data */
+  unsigned int error = lodepng_inspect(w, h, &state, png, png_size);
+  const LodePNGColorType type = state.info_png.color.colortype;
+
+  if (!error && (type == LCT_PALETTE || type == LCT_GREY)) {
+    state.decoder.color_convert = 0;
+  } else if (!error && type == LCT_GREY_ALPHA) {
+    state.info_raw.colortype = LCT_GREY_ALPHA;
+    state.info_raw.bitdepth = 8;
+  }
+  if (!error) {
+    error = lodepng_decode(&raw, w, h, &state, png, png_size);
+  }
+  if (error) {
+    png2pos_arena_free(raw);
+    lodepng_state_cleanup(&state);
+    return error;
+  }
+
+  const LodePNGColorMode *color = &state.info_png.color;
+  const unsigned int depth = color->bitdepth;
+  const size_t n = (size_t)*w * *h;
+
+  *grey = raw;
+
+  if (type == LCT_RGB || type == LCT_RGBA) {
+    /* RGBA over the background → RGB → L*; pixel i is written to byte i,
+       which has already been read, so the grey plane reuses the buffer */
+    png2pos_rgba_to_grey(raw, raw, n, background, histogram);
+  } else if (type == LCT_GREY_ALPHA) {
+    png2pos_grey_alpha_to_grey(raw, raw, n, background, histogram);
+  } else if (type == LCT_GREY && depth == 16) {
+    /* high byte, or the background where the level is transparent */
+    for (size_t i = 0; i != n; ++i) {
+      unsigned int v = (unsigned int)raw[i << 1] << 8 | raw[(i << 1) + 1];
+
+      raw[i] = color->key_defined && v == color->key_r ? background
+               : raw[i << 1];
+      ++histogram[raw[i]];
+    }
+  } else if (type == LCT_GREY && depth == 8 && !color->key_defined) {
+    for (size_t i = 0; i != n; ++i) {
+      ++histogram[raw[i]];
+    }
+  } else {
+    unsigned char lut[256];
+
+    if (type == LCT_PALETTE) {
+      png2pos_palette_to_grey(color->palette,
+                              (unsigned int)color->palettesize, background,
+                              lut);
+    } else {
+      const unsigned int max = (1u << depth) - 1;
+
+      for (unsigned int i = 0; i != 256; ++i) {
+        lut[i] = (unsigned char)(i <= max ? i * 255 / max : 0);
+      }
+      if (color->key_defined && color->key_r <= max) {
+        lut[color->key_r] = background;
+      }
+    }
+
+    /* line art and pre-dithered images are packed straight from their
+       bits */
+    if (depth == 1 && keep_bits) {
+      levels[0] = lut[0];
+      levels[1] = lut[1];
+      *bits = 1;
+      lodepng_state_cleanup(&state);
+      return 0;
+    }
+
+    /* indexes narrower than a byte need a plane of their own */
+    if (depth != 8) {
+      *grey = (unsigned char *)png2pos_arena_alloc(n ? n : 1);
+    }
+    if (*grey) {
+      png2pos_index_to_grey(raw, depth, *grey, n, lut, histogram);
+    } else {
+      error = 83; /* lodepng's alloc fail */
+    }
+    if (*grey != raw) {
+      png2pos_arena_free(raw);
+    }
+  }
+
+  lodepng_state_cleanup(&state);
+  return error;
+}
+
+/* shortest run of white rows fed past instead of rastered, a millimetre
+   at 203 dpi; every feed splits a block and so stops the print head for
+   another command, which a few rows are not worth even where the bytes
+   saved would pay for it (a single row of a full width image) */
+#define FEED_MIN_ROWS 8u
+
+/* feed n dot rows, setting the motion unit first if that has not been
+   done yet (*motion); left as it is if it cannot be set */
+static void s_feed(unsigned int n, unsigned int dpi, unsigned int *motion,
+                   struct png2pos_sink *sink) {
+  if (!*motion) {
+    *motion = png2pos_raster_motion(dpi, sink) ? 1 : 2;
+  }
+  png2pos_raster_feed(n, sink);
+}
+
+/* number of all-white rows of a packed band starting at row y */
+static unsigned int s_blank_rows(const unsigned char *band,
+                                 unsigned int row_bytes, unsigned int y,
+                                 unsigned int k) {
+  unsigned int n = 0;
+
+  for (; y + n != k; ++n) {
+    const unsigned char *row = &band[(y + n) * row_bytes];
+
+    for (unsigned int i = 0; i != row_bytes; ++i) {
+      if (row[i]) {
+        return n;
+      }
+    }
+  }
+
+  return n;
+}
+
+/* number of pairs of identical rows of a packed band, one after the
+   other, starting at row y */
+static unsigned int s_row_pairs(const unsigned char *band,
+                                unsigned int row_bytes, unsigned int y,
+                                unsigned int k) {
+  unsigned int n = 0;
+
+  while (y + 2 * n + 1 < k &&
+         !memcmp(&band[(y + 2 * n) * row_bytes],
+                 &band[(y + 2 * n + 1) * row_bytes], row_bytes)) {
+    ++n;
+  }
+
+  return n;
+}
+
+/* send k rows of a band as blocks of the given raster command set; with
+   compress, runs of identical row pairs long enough to pay for the extra
+   blocks are stored once and printed at double height (by = 2); the rows
+   are compacted in place, so bits is clobbered; returns the bytes saved
+   against a single plain block */
+static size_t s_emit(enum png2pos_raster raster, unsigned char *bits,
+                     unsigned int canvas_w, unsigned int k,
+                     unsigned int compress,
+                     struct png2pos_sink *sink) {
+  const unsigned int row_bytes = canvas_w >> 3;
+  const unsigned int cost = png2pos_raster_block_cost(raster);
+
+  if (!compress || !png2pos_raster_can_zoom(raster)) {
+    png2pos_raster_block(raster, bits, canvas_w, k, 1, sink);
+    return 0;
+  }
+
+  /* a double height block may split a plain one in two */
+  const unsigned int pairs_min = 2 * cost / row_bytes + 1;
+  size_t sent = 0;
+  unsigned int y = 0; /* first row not sent yet */
+
+  for (unsigned int r = 0; r + 1 < k; ) {
+    unsigned int n = s_row_pairs(bits, row_bytes, r, k);
+
+    if (n < pairs_min) {
+      ++r;
+      continue;
+    }
+
+    if (r != y) {
+      png2pos_raster_block(raster, &bits[y * row_bytes], canvas_w, r - y, 1,
+                           sink);
+      sent += cost + (r - y) * row_bytes;
+    }
+
+    /* keep the first row of every pair */
+    for (unsigned int i = 1; i != n; ++i) {
+      memcpy(&bits[(r + i) * row_bytes], &bits[(r + 2 * i) * row_bytes],
+             row_bytes);
+    }
+    png2pos_raster_block(raster, &bits[r * row_bytes], canvas_w, n, 2,
+                         sink);
+    sent += cost + n * row_bytes;
+
+    r += 2 * n;
+    y = r;
+  }
+
+  if (y != k) {
+    png2pos_raster_block(raster, &bits[y * row_bytes], canvas_w, k - y, 1,
+                         sink);
+    sent += cost + (k - y) * row_bytes;
+  }
+
+  return cost + k * row_bytes - sent;
+}
+
+void png2pos_options_init(struct png2pos_options *opt) {
+  opt->photo = 0;
+  opt->dither = PNG2POS_DITHER_JJN;
+  opt->threads = 1;
+  opt->align = '?';
+  opt->rotate = 0;
+  opt->width = 0;
+  opt->compress = 0;
+  opt->raster = PNG2POS_RASTER_GS8L;
+  opt->store = PNG2POS_STORE_NONE;
+  opt->key[0] = ' ';
+  opt->key[1] = ' ';
+  opt->tone.equalise = PNG2POS_EQUALISE_GLOBAL;
+  opt->tone.gamma = 1;
+  opt->tone.contrast = 1;
+  opt->tone.brightness = 0;
+  opt->tone.clip_limit = 3;
+  opt->background = 255;
+
+  /* printer_max_width, dpi, gs8l_max_y, buffer and speed */
+  png2pos_profile_apply(png2pos_profile_at(0), opt);
+}
+
+static unsigned int s_convert(const unsigned char *png, size_t png_size,
+                              const struct png2pos_options *options,
+                              struct png2pos_sink *sink,
+                              struct png2pos_stats *stats) {
+
+  /* the caller's options are never modified */
+  struct png2pos_options opt = *options;
+
+  unsigned char *img_grey = NULL;
+  unsigned char *img_bw = NULL;
+  unsigned char *img_row = NULL;
+  short *img_err = NULL;
+
+  opt.printer_max_width &= ~0x7u;
+
+  if (stats) {
+    stats->saved = 0;
+    stats->seconds = 0;
+  }
+
+  /* load the PNG as L* */
+  unsigned int img_w = 0;
+  unsigned int img_h = 0;
+  unsigned int histogram[256] = { 0 };
+
+  /* a B/W image of two levels can be thresholded as a whole, so a 1 bit
+     PNG is kept as a bit plane in img_grey and repacked row by row */
+  unsigned int bits = !opt.photo;
+  unsigned char levels[2] = { 0, 255 };
+  unsigned int lodepng_error = s_decode_grey(png, png_size, opt.background,
+                                             &img_grey, &img_w, &img_h,
+                                             histogram, &bits, levels);
+
+  if (lodepng_error) {
+    // fprintf(stderr, "Could not load and process input PNG file, %s\n",
+    //         lodepng_error_text(lodepng_error));
+    return lodepng_error;
+  }
+
+  /* turned a quarter, the image is printed sideways and its height runs
+     across the paper */
+  const unsigned int quarter = opt.rotate == 90 || opt.rotate == 270;
+
+  /* scale down so that it prints as wide as asked for, never wider than
+     the printer; the image is not enlarged */
+  unsigned int fit_w = opt.width && opt.width < opt.printer_max_width
+                       ? opt.width : opt.printer_max_width;
+  unsigned int out_w = img_w;
+  unsigned int out_h = img_h;
+
+  if (quarter && fit_w < img_h) {
+    out_h = fit_w;
+    out_w = png2pos_scale_height(img_h, img_w, fit_w);
+  } else if (!quarter && fit_w < img_w) {
+    out_w = fit_w;
+    out_h = png2pos_scale_height(img_w, img_h, fit_w);
+  }
+
+  if (opt.store && (quarter ? out_w : out_h) > PNG2POS_STORE_MAX_Y) {
+    // fprintf(stderr, "Image height %u px exceeds what the printer can"
+    //           " store (%u px)\n", quarter ? out_w : out_h,
+    //           PNG2POS_STORE_MAX_Y);
+    png2pos_arena_free(img_grey);
+    return 1;
+  }
+
+  unsigned int img_grey_size = img_h * img_w;
+
+  /* averaging makes levels in between, a bit plane to be scaled is
+     expanded to grey first */
+  if (bits && (out_w != img_w || out_h != img_h)) {
+    unsigned char lut[256] = { levels[0], levels[1] };
+    unsigned char *grey;
+
+    grey = (unsigned char *)png2pos_arena_alloc(img_grey_size);
+    if (!grey) {
+      // fprintf(stderr, "Could not allocate enough memory\n");
+      png2pos_arena_free(img_grey);
+      return 1;
+    }
+    png2pos_index_to_grey(img_grey, 1, grey, img_grey_size, lut, histogram);
+    png2pos_arena_free(img_grey);
+    img_grey = grey;
+    bits = 0;
+  }
+
+  /* area-average the grey plane down in place; the histogram is of the
+     scaled image */
+  if (out_w != img_w || out_h != img_h) {
+    memset(histogram, 0, sizeof histogram);
+    if (png2pos_scale_grey(img_grey, img_w, img_h, out_w, out_h,
+                           histogram)) {
+      // fprintf(stderr, "Could not allocate enough memory\n");
+      png2pos_arena_free(img_grey);
+      return 1;
+    }
+    img_w = out_w;
+    img_h = out_h;
+    img_grey_size = img_h * img_w;
+  }
+
+  /* give back the rest of a buffer the decoder made larger */
+  if (img_grey_size && !bits) {
+    unsigned char *shrunk;
+
+    shrunk = (unsigned char *)png2pos_arena_realloc(img_grey, img_grey_size);
+    if (shrunk) {
+      img_grey = shrunk;
+    }
+  }
+
+  {
+    /* -p hints */
+    unsigned int colors = 0;
+
+    for (unsigned int i = 0; i != 256; ++i) {
+      if (histogram[i]) {
+        ++colors;
+      }
+    }
+    if (colors < 16 && opt.photo) {
+      fprintf(stderr, "Image seems to be B/W. -p is probably"
+                " not good option this time\n");
+    }
+    if (colors >= 16 && !opt.photo) {
+      fprintf(stderr, "Image seems to be greyscale or colored."
+                " Maybe you should use option -p for better results\n");
+    }
+  }
+
+  /* size of the image as printed */
+  const unsigned int print_w = quarter ? img_h : img_w;
+  const unsigned int print_h = quarter ? img_w : img_h;
+
+  /* the raster is only as wide as the image, rounded up to whole bytes;
+     the printer itself places it on the paper (ESC a) */
+  unsigned int canvas_w = (print_w + 7) & ~0x7u;
+
+  /* band height of the raster command set; a stored graphic is defined
+     in one piece */
+  unsigned int band_h = opt.store ? print_h
+                                  : png2pos_raster_band_rows(opt.raster,
+                                                             canvas_w,
+                                                             opt.gs8l_max_y,
+                                                             opt.buffer);
+
+  /* one band of bitmap, reused for every chunk, and one packed image row */
+  img_bw = (unsigned char *)png2pos_arena_alloc(band_h * (canvas_w >> 3));
+  img_row = (unsigned char *)png2pos_arena_alloc((img_w + 7) >> 3);
+  if (!img_bw || !img_row) {
+    // fprintf(stderr, "Could not allocate enough memory\n");
+    png2pos_arena_free(img_row);
+    png2pos_arena_free(img_bw);
+    png2pos_arena_free(img_grey);
+    return 1;
+  }
+
+  size_t img_err_size = png2pos_dither_state_size(opt.dither, img_w,
+                                                  opt.threads);
+  if (opt.photo && img_err_size) {
+    img_err = (short *)png2pos_arena_alloc(img_err_size * sizeof *img_err);
+    if (img_err) {
+      memset(img_err, 0, img_err_size * sizeof *img_err);
+    } else {
+      // fprintf(stderr, "Could not allocate enough memory\n");
+      png2pos_arena_free(img_row);
+      png2pos_arena_free(img_bw);
+      png2pos_arena_free(img_grey);
+      return 1;
+    }
+  }
+
+  /* tone curve, and the Histogram Equalization Algorithm in photo mode,
+     applied to each band just before it is dithered */
+  struct png2pos_tone_curve curve = opt.tone;
+  struct png2pos_tone tone;
+
+  if (!opt.photo) {
+    curve.equalise = PNG2POS_EQUALISE_NONE;
+  }
+  if (png2pos_tone_init(&tone, &curve, img_grey, img_w, img_h, histogram,
+                        opt.threads)) {
+    // fprintf(stderr, "Could not allocate enough memory\n");
+    png2pos_arena_free(img_err);
+    png2pos_arena_free(img_row);
+    png2pos_arena_free(img_bw);
+    png2pos_arena_free(img_grey);
+    return 1;
+  }
+
+  /* which of the two levels of a bit plane print as dots, as the grey
+     pipeline would threshold them; nothing is left to map or dither */
+  unsigned int black0 = 0;
+  unsigned int black1 = 0;
+  unsigned int dithered = 0;
+
+  if (bits) {
+    black0 = tone.lut[levels[0]] <= 0x80;
+    black1 = tone.lut[levels[1]] <= 0x80;
+    dithered = img_h;
+  }
+
+  /* a quarter turn needs the whole image: it is tone mapped, dithered and
+     packed in one go, then the bitmap is turned on its side */
+  unsigned char *img_turned = NULL;
+
+  if (quarter) {
+    const unsigned int src_bytes = (img_w + 7) >> 3;
+    unsigned char *img_bits;
+
+    img_bits = (unsigned char *)png2pos_arena_alloc((size_t)img_h
+                                                    * src_bytes);
+    img_turned = (unsigned char *)png2pos_arena_alloc((size_t)print_h
+                                                      * (canvas_w >> 3));
+
+    if (!img_bits || !img_turned) {
+      // fprintf(stderr, "Could not allocate enough memory\n");
+      png2pos_arena_free(img_turned);
+      png2pos_arena_free(img_bits);
+      png2pos_tone_free(&tone);
+      png2pos_arena_free(img_err);
+      png2pos_arena_free(img_row);
+      png2pos_arena_free(img_bw);
+      png2pos_arena_free(img_grey);
+      return 1;
+    }
+
+    if (dithered < img_h) {
+      png2pos_tone_rows(&tone, img_grey, 0, img_h, opt.threads);
+      if (opt.photo) {
+        png2pos_dither_rows(opt.dither, img_grey, img_err, img_w, 0, img_h,
+                            opt.threads);
+      }
+      dithered = img_h;
+    }
+
+    for (unsigned int y = 0; y != img_h; ++y) {
+      if (bits) {
+        png2pos_repack_row(img_grey, (size_t)y * img_w, img_w, black0,
+                           black1, &img_bits[(size_t)y * src_bytes]);
+      } else {
+        png2pos_pack_row(&img_grey[(size_t)y * img_w], img_w,
+                         &img_bits[(size_t)y * src_bytes]);
+      }
+    }
+    png2pos_rotate_bits(img_bits, img_w, img_h, opt.rotate == 270,
+                        img_turned);
+    png2pos_arena_free(img_bits);
+  }
+
+  /* align image turned upside down to the right border */
+  if (opt.rotate == 180 && opt.align == '?') {
+    opt.align = 'R';
+  }
+
+  /* a stored graphic is placed when it is printed */
+  if (opt.store) {
+    opt.align = 'L';
+  }
+
+  /* justification, and left offset of the image within its last byte */
+  unsigned char justify = 0;
+  unsigned int offset = 0;
+
+  switch (opt.align) {
+  case 'C':
+    justify = 1;
+    offset = (canvas_w - print_w) / 2;
+    break;
+
+  case 'R':
+    justify = 2;
+    offset = canvas_w - print_w;
+    break;
+
+  case 'L':
+  case '?':
+  default:
+    justify = 0;
+    offset = 0;
+  }
+
+  const unsigned char ESC_INIT[2] = {
+      /* ESC @, Initialize printer, p. 412 */
+      0x1b, 0x40
+  };
+
+  if (!opt.store) {
+    png2pos_sink_write(sink, ESC_INIT, sizeof ESC_INIT);
+  }
+
+  if (justify) {
+    const unsigned char ESC_JUSTIFY[3] = {
+      /* ESC a, Select justification, p. 93; also applies to the raster
+         and bit image commands */
+      0x1b, 0x61, justify
+    };
+    png2pos_sink_write(sink, ESC_JUSTIFY, sizeof ESC_JUSTIFY);
+  }
+
+  /* ESC J feeds by the vertical motion unit, which the printer's default
+     need not make one dot row (1 = set to one, 2 = could not be set);
+     column mode feeds after every line */
+  unsigned int motion = 0;
+
+  if (!opt.store && opt.raster == PNG2POS_RASTER_COLUMN) {
+    motion = png2pos_raster_motion(opt.dpi, sink) ? 1 : 2;
+  }
+
+  /* chunking, l = lines already printed, currently processing a
+   chunk of height k; dithered = rows of img_grey already tone mapped and
+   dithered */
+  for (unsigned int l = 0, k = band_h; l < print_h && !sink->error;
+       l += k) {
+
+    if (k > print_h - l) {
+      k = print_h - l;
+    }
+
+    /* an upside down band is taken from the bottom of the image, which
+       can only be dithered once everything above it is; turned a quarter
+       the image was dithered whole above */
+    unsigned int need = opt.rotate ? img_h : l + k;
+
+    if (dithered < need) {
+      png2pos_tone_rows(&tone, img_grey, dithered, need, opt.threads);
+
+      if (opt.photo) {
+        png2pos_dither_rows(opt.dither, img_grey, img_err, img_w, dithered,
+                            need, opt.threads);
+      }
+      dithered = need;
+    }
+
+    /* compress bytes into bitmap, an upside down row is the mirror of its
+       counterpart from the bottom of the image */
+    memset(img_bw, 0, k * (canvas_w >> 3));
+
+    for (unsigned int y = 0; y != k; ++y) {
+      if (img_turned) {
+        png2pos_place_row(&img_bw[y * (canvas_w >> 3)], offset,
+                          &img_turned[(size_t)(l + y) * (canvas_w >> 3)],
+                          print_w);
+        continue;
+      }
+
+      unsigned int src = opt.rotate == 180 ? img_h - 1 - (l + y) : l + y;
+
+      if (bits) {
+        png2pos_repack_row(img_grey, (size_t)src * img_w, img_w, black0,
+                           black1, img_row);
+      } else {
+        png2pos_pack_row(&img_grey[src * img_w], img_w, img_row);
+      }
+      if (opt.rotate == 180) {
+        png2pos_reverse_row(img_row, img_w);
+      }
+      png2pos_place_row(&img_bw[y * (canvas_w >> 3)], offset, img_row, img_w);
+    }
+
+    if (opt.store) {
+      png2pos_raster_define(opt.store, opt.key, img_bw, canvas_w, k, sink);
+      continue;
+    }
+
+    const unsigned int row_bytes = canvas_w >> 3;
+    const unsigned int cost = png2pos_raster_block_cost(opt.raster);
+
+    /* a band that cannot be split is sent whole, or fed past if white */
+    if (!cost) {
+      if (s_blank_rows(img_bw, row_bytes, 0, k) == k) {
+        s_feed(k, opt.dpi, &motion, sink);
+      } else {
+        png2pos_raster_block(opt.raster, img_bw, canvas_w, k, 1, sink);
+      }
+      continue;
+    }
+
+    /* runs of white rows are fed past (ESC J) instead of being sent as
+       zero bytes; shorter runs stay in the raster, where they are cheaper
+       than splitting the block around them (one more block and the ESC J) */
+    unsigned int feed_min = (cost + 3) / row_bytes + 1;
+
+    if (feed_min < FEED_MIN_ROWS) {
+      feed_min = FEED_MIN_ROWS;
+    }
+
+    for (unsigned int y = 0; y != k; ) {
+      unsigned int n = s_blank_rows(img_bw, row_bytes, y, k);
+
+      if (n >= feed_min) {
+        s_feed(n, opt.dpi, &motion, sink);
+        y += n;
+        continue;
+      }
+
+      /* raster up to the next run of white rows worth feeding */
+      unsigned int e = y + n;
+
+      while (e != k) {
+        unsigned int m = s_blank_rows(img_bw, row_bytes, e, k);
+
+        if (m >= feed_min) {
+          break;
+        }
+        e += m ? m : 1;
+      }
+
+      size_t saved = s_emit(opt.raster, &img_bw[y * row_bytes], canvas_w,
+                            e - y, opt.compress, sink);
+      if (stats) {
+        stats->saved += saved;
+      }
+      y = e;
+    }
+  }
+
+  /* back to the default motion unit, as after ESC @ */
+  if (motion == 1) {
+    png2pos_raster_motion(0, sink);
+  }
+
+  if (justify) {
+    /* back to left justification for whatever is printed next */
+    const unsigned char ESC_JUSTIFY_LEFT[3] = {
+      0x1b, 0x61, 0x00
+    };
+    png2pos_sink_write(sink, ESC_JUSTIFY_LEFT, sizeof ESC_JUSTIFY_LEFT);
+  }
+
+  /* every row is either printed or fed past */
+  if (stats && !opt.store && opt.dpi && opt.speed) {
+    stats->seconds = print_h * 25.4 / ((double)opt.dpi * opt.speed);
+  }
+
+  png2pos_tone_free(&tone);
+
+  png2pos_arena_free(img_turned);
+  img_turned = NULL;
+
+  png2pos_arena_free(img_err);
+  img_err = NULL;
+
+  png2pos_arena_free(img_row);
+  img_row = NULL;
+
+  png2pos_arena_free(img_bw);
+  img_bw = NULL;
+
+  png2pos_arena_free(img_grey);
+  img_grey = NULL;
+
+  return sink->error ? 1 : 0;
+
+}
+
+unsigned int png2pos_convert(const unsigned char *png, size_t png_size,
+                             const struct png2pos_options *options,
+                             struct png2pos_sink *sink,
+                             struct png2pos_stats *stats) {
+  /* the decoder and every buffer of the job come from the thread's
+     scratch arena, all given back when the job ends, also if the
+     conversion throws */
+  struct png2pos_arena_job job;
+
+  return s_convert(png, png_size, options, sink, stats);
+}
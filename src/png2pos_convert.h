@@ -0,0 +1,71 @@
+/* png2pos_convert.h, PNG → ESC/POS raster conversion
+
+   The converter keeps no global state: everything it needs comes with the
+   call, so conversions may run concurrently from any number of threads.
+   It does not touch R either and can be used from plain C++ workers. */
+
+#ifndef PNG2POS_CONVERT_H
+#define PNG2POS_CONVERT_H
+
+#include <stddef.h>
+#include "png2pos_dither.h"
+#include "png2pos_raster.h"
+#include "png2pos_tone.h"
+
+/* conversion options */
+struct png2pos_options {
+  unsigned int photo; /* histogram equalisation and dithering */
+  enum png2pos_dither dither; /* dithering method for photo mode */
+  unsigned int threads; /* threads used for dithering */
+  char align; /* 'L', 'C', 'R' or '?' (left, right when rotated by 180°) */
+  unsigned int rotate; /* 0, 90, 180 or 270, degrees clockwise */
+  unsigned int gs8l_max_y; /* rows per GS 8 L band */
+  unsigned int printer_max_width; /* dots, divisible by 8 */
+  unsigned int dpi; /* printer resolution */
+  unsigned int buffer; /* printer receive buffer, bytes; sizes GS v 0
+                          bands */
+  unsigned int width; /* dots to scale wider images down to, 0 = scale
+                         only those wider than printer_max_width */
+  unsigned int speed; /* nominal print speed, mm/s */
+  unsigned int compress; /* send runs of identical row pairs once, printed
+                            at double height */
+  enum png2pos_raster raster; /* raster command set */
+  enum png2pos_store store; /* define a stored graphic instead of printing */
+  unsigned char key[2]; /* key code of the stored graphic */
+  struct png2pos_tone_curve tone; /* tone curve; equalisation in photo mode
+                                     only */
+  unsigned char background; /* grey level transparent pixels are blended
+                               over, 255 = paper white */
+};
+
+/* what a conversion achieved */
+struct png2pos_stats {
+  size_t saved; /* bytes saved by compress */
+  double seconds; /* time the stream takes to print at nominal speed */
+};
+
+/* set the defaults: B/W, left aligned, uncompressed GS 8 L, neutral tone
+   curve with global equalisation, white background, images scaled down
+   to the printer width only if wider, printer geometry from the default
+   printer profile (png2pos_profile.h) */
+void png2pos_options_init(struct png2pos_options *opt);
+
+/* convert a PNG image held in memory to an ESC/POS raster stream; images
+   wider than the width asked for or than the printer are scaled down
+   first, keeping their aspect ratio; the image is processed in bands
+   (gs8l_max_y rows for GS 8 L) and every band is written to sink as soon
+   as it has been dithered and packed, so besides the grey plane (or the
+   decoded bit plane of 1-bit images) only one band of bitmap is held;
+   turned by 90 or 270 degrees the whole bitmap is held to be transposed,
+   and with store set the stream is a single command defining the image
+   as stored graphic key, so it too holds the whole bitmap; returns 0 on
+   success, a non-zero value if the image could not be decoded, does not
+   fit the printer or the sink failed (the conversion stops at the next
+   band); what a descriptor sink still has staged is left to
+   png2pos_sink_flush(); stats, if not NULL, is filled in */
+unsigned int png2pos_convert(const unsigned char *png, size_t png_size,
+                             const struct png2pos_options *opt,
+                             struct png2pos_sink *sink,
+                             struct png2pos_stats *stats);
+
+#endif /* PNG2POS_CONVERT_H */
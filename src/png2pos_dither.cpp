@@ -0,0 +1,412 @@
+#include <string.h>
+#include <atomic>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "png2pos_dither.h"
+#include "png2pos_bluenoise.h"
+
+/* Error diffusion
+
+   http://www.tannerhelland.com/4660/
+   dithering-eleven-algorithms-source-code/
+
+   The error is not written back into img_grey but kept, in 1/DIV of a
+   level, in three rolling rows of img_err (row y lives in y % 3), each
+   ERR_PAD columns wider on either side so that no tap needs a bounds
+   check; |error| never exceeds 128 levels, so a short holds the sum.
+
+   Every kernel is a struct with its divisor and a spread() pushing the
+   error d of pixel x into the current (e0) and the next two rows (e1, e2);
+   for simplicity of computation, all standard dithering formulas push the
+   error forward, never backward. */
+#define ERR_PAD 2
+
+static inline int s_err_stride(unsigned int img_w) {
+  return img_w + 2 * ERR_PAD;
+}
+
+/* Jarvis, Judice, and Ninke Dithering
+
+   In the same year that Floyd and Steinberg published their
+   famous dithering algorithm, a lesser-known – but much more
+   powerful – algorithm was also published. With this
+   algorithm, the error is distributed to three times as many
+   pixels as in Floyd-Steinberg, leading to much smoother –
+   and more subtle – output. */
+struct jjn_kernel {
+  enum { DIV = 48 };
+  static inline void spread(short *e0, short *e1, short *e2, int x, int d) {
+    e0[x + 1] += 7 * d;
+    e0[x + 2] += 5 * d;
+    e1[x - 2] += 3 * d;
+    e1[x - 1] += 5 * d;
+    e1[x    ] += 7 * d;
+    e1[x + 1] += 5 * d;
+    e1[x + 2] += 3 * d;
+    e2[x - 2] += 1 * d;
+    e2[x - 1] += 3 * d;
+    e2[x    ] += 5 * d;
+    e2[x + 1] += 3 * d;
+    e2[x + 2] += 1 * d;
+  }
+};
+
+/* Floyd-Steinberg, the classic 7-3-5-1 */
+struct floyd_steinberg_kernel {
+  enum { DIV = 16 };
+  static inline void spread(short *e0, short *e1, short *, int x, int d) {
+    e0[x + 1] += 7 * d;
+    e1[x - 1] += 3 * d;
+    e1[x    ] += 5 * d;
+    e1[x + 1] += 1 * d;
+  }
+};
+
+/* Atkinson (Apple's MacPaint), spreads only 3/4 of the error, which
+   keeps highlights and shadows clean at the cost of some detail */
+struct atkinson_kernel {
+  enum { DIV = 8 };
+  static inline void spread(short *e0, short *e1, short *e2, int x, int d) {
+    e0[x + 1] += d;
+    e0[x + 2] += d;
+    e1[x - 1] += d;
+    e1[x    ] += d;
+    e1[x + 1] += d;
+    e2[x    ] += d;
+  }
+};
+
+/* Stucki, JJN with weights closer to the pixel */
+struct stucki_kernel {
+  enum { DIV = 42 };
+  static inline void spread(short *e0, short *e1, short *e2, int x, int d) {
+    e0[x + 1] += 8 * d;
+    e0[x + 2] += 4 * d;
+    e1[x - 2] += 2 * d;
+    e1[x - 1] += 4 * d;
+    e1[x    ] += 8 * d;
+    e1[x + 1] += 4 * d;
+    e1[x + 2] += 2 * d;
+    e2[x - 2] += 1 * d;
+    e2[x - 1] += 2 * d;
+    e2[x    ] += 4 * d;
+    e2[x + 1] += 2 * d;
+    e2[x + 2] += 1 * d;
+  }
+};
+
+/* Sierra Lite, nearly Floyd-Steinberg quality with three taps */
+struct sierra_lite_kernel {
+  enum { DIV = 4 };
+  static inline void spread(short *e0, short *e1, short *, int x, int d) {
+    e0[x + 1] += 2 * d;
+    e1[x - 1] += d;
+    e1[x    ] += d;
+  }
+};
+
+/* number of rolling error rows: the row being dithered and the two it
+   pushes error into, plus one more for every extra row in flight */
+static inline unsigned int s_err_rows(unsigned int threads) {
+  return threads > 1 ? threads + 3 : 3;
+}
+
+/* dither pixels [x_from; x_to) of one row */
+template <class K>
+static inline void s_diffuse_span(unsigned char *px, short *e0, short *e1,
+                                  short *e2, int x_from, int x_to) {
+  for (int x = x_from; x != x_to; ++x) {
+    /* round the diffused error to the nearest level */
+    int o = px[x] + (e0[x] + 128 * K::DIV + K::DIV / 2) / K::DIV - 128;
+    int n = o <= 0x80 ? 0x00 : 0xff;
+
+    px[x] = n;
+    K::spread(e0, e1, e2, x, o - n);
+  }
+}
+
+/* dither rows [y_from; y_to) one after the other, row y keeps its error
+   in ring slot y % rows */
+template <class K>
+static void s_diffuse(unsigned char *img_grey, short *img_err,
+                      unsigned int img_w, unsigned int rows,
+                      unsigned int y_from, unsigned int y_to) {
+
+  const int stride = s_err_stride(img_w);
+
+  for (unsigned int y = y_from; y != y_to; ++y) {
+    short *e0 = &img_err[(y % rows) * stride + ERR_PAD];
+
+    s_diffuse_span<K>(&img_grey[y * img_w], e0,
+                      &img_err[((y + 1) % rows) * stride + ERR_PAD],
+                      &img_err[((y + 2) % rows) * stride + ERR_PAD],
+                      0, img_w);
+
+    /* this row is done, it comes back as row y + rows */
+    memset(e0 - ERR_PAD, 0, stride * sizeof *e0);
+  }
+}
+
+/* Wavefront: thread t dithers rows y_from + t, y_from + t + threads, ...
+   and pixel x of row y only once row y - 1 is WAVE_LAG pixels ahead.
+   By then everything pushed into e0[x] is in (taps reach 2 pixels to the
+   right), and the two rows' writes into row y + 1 (both reach 2 pixels
+   left and right) can not overlap, so every pixel sees exactly the sums
+   of the serial kernel. Progress is published every WAVE_STEP pixels as
+   (y + 1) << 32 | pixels done, which only grows per ring slot. */
+#define WAVE_LAG 5
+#define WAVE_STEP 32
+
+struct wavefront {
+  unsigned char *img_grey;
+  short *img_err;
+  unsigned int img_w;
+  unsigned int y_from;
+  unsigned int y_to;
+  unsigned int threads; /* threads that took part, known once started */
+  unsigned int rows;
+  std::atomic<unsigned long long> *progress;
+  std::atomic<unsigned int> started;
+};
+
+static inline unsigned long long s_wave_mark(unsigned int y, unsigned int x) {
+  return (unsigned long long)(y + 1) << 32 | x;
+}
+
+template <class K>
+static void s_diffuse_wave(struct wavefront *wf, unsigned int t) {
+
+  const int stride = s_err_stride(wf->img_w);
+  const int w = wf->img_w;
+
+  /* rows are dealt out by the number of threads that could be started */
+  while (!wf->started.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+
+  for (unsigned int y = wf->y_from + t; y < wf->y_to; y += wf->threads) {
+    unsigned char *px = &wf->img_grey[y * w];
+    short *e0 = &wf->img_err[(y % wf->rows) * stride + ERR_PAD];
+    short *e1 = &wf->img_err[((y + 1) % wf->rows) * stride + ERR_PAD];
+    short *e2 = &wf->img_err[((y + 2) % wf->rows) * stride + ERR_PAD];
+    std::atomic<unsigned long long> &above =
+      wf->progress[(y + wf->rows - 1) % wf->rows];
+    std::atomic<unsigned long long> &mine = wf->progress[y % wf->rows];
+
+    for (int x = 0; x < w; x += WAVE_STEP) {
+      int x_to = x + WAVE_STEP < w ? x + WAVE_STEP : w;
+      int need = x_to - 1 + WAVE_LAG < w ? x_to - 1 + WAVE_LAG : w;
+
+      while (above.load(std::memory_order_acquire) < s_wave_mark(y - 1, need)) {
+        std::this_thread::yield();
+      }
+
+      s_diffuse_span<K>(px, e0, e1, e2, x, x_to);
+
+      if (x_to < w) {
+        mine.store(s_wave_mark(y, x_to), std::memory_order_release);
+      }
+    }
+
+    /* this row is done, it comes back as row y + rows */
+    memset(e0 - ERR_PAD, 0, stride * sizeof *e0);
+    mine.store(s_wave_mark(y, w), std::memory_order_release);
+  }
+}
+
+template <class K>
+static void s_diffuse_parallel(unsigned char *img_grey, short *img_err,
+                               unsigned int img_w, unsigned int y_from,
+                               unsigned int y_to, unsigned int threads) {
+
+  struct wavefront wf;
+  wf.img_grey = img_grey;
+  wf.img_err = img_err;
+  wf.img_w = img_w;
+  wf.y_from = y_from;
+  wf.y_to = y_to;
+  wf.threads = threads;
+  wf.rows = s_err_rows(threads);
+
+  std::vector<std::atomic<unsigned long long> > progress(wf.rows);
+  for (unsigned int i = 0; i != wf.rows; ++i) {
+    progress[i].store(0);
+  }
+  /* the row above the first one is complete (or does not exist) */
+  progress[(y_from + wf.rows - 1) % wf.rows].store(s_wave_mark(y_from - 1, img_w));
+  wf.progress = progress.data();
+
+  wf.started.store(0);
+
+  /* a thread that cannot be started leaves its rows to the others */
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  try {
+    for (unsigned int t = 1; t < threads; ++t) {
+      workers.push_back(std::thread(s_diffuse_wave<K>, &wf, t));
+    }
+  } catch (const std::system_error &) {
+  }
+  wf.threads = (unsigned int)workers.size() + 1;
+  wf.started.store(1, std::memory_order_release);
+
+  s_diffuse_wave<K>(&wf, 0);
+  for (unsigned int t = 0; t != workers.size(); ++t) {
+    workers[t].join();
+  }
+}
+
+template <class K>
+static void s_diffuse_rows(unsigned char *img_grey, short *img_err,
+                           unsigned int img_w, unsigned int y_from,
+                           unsigned int y_to, unsigned int threads) {
+  /* a narrow image leaves too little room between the rows in flight and
+     a short run is not worth starting threads for; the ring is laid out
+     for threads either way */
+  if (threads > 1 && img_w >= 4 * WAVE_STEP && y_to - y_from >= 2 * threads) {
+    s_diffuse_parallel<K>(img_grey, img_err, img_w, y_from, y_to, threads);
+  } else {
+    s_diffuse<K>(img_grey, img_err, img_w, s_err_rows(threads), y_from, y_to);
+  }
+}
+
+/* Ordered dithering, 8×8 Bayer index matrix scaled to 0..251 */
+static const unsigned char bayer_mask[8][8] = {
+  {   0, 127,  31, 159,   7, 135,  39, 167 },
+  { 191,  63, 223,  95, 199,  71, 231, 103 },
+  {  47, 175,  15, 143,  55, 183,  23, 151 },
+  { 239, 111, 207,  79, 247, 119, 215,  87 },
+  {  11, 139,  43, 171,   3, 131,  35, 163 },
+  { 203,  75, 235, 107, 195,  67, 227,  99 },
+  {  59, 187,  27, 155,  51, 179,  19, 147 },
+  { 251, 123, 219,  91, 243, 115, 211,  83 }
+};
+
+/* a pixel is black where it is not lighter than the mask; mask_w and
+   mask_h are powers of two */
+static void s_threshold(unsigned char *img_grey, const unsigned char *mask,
+                        unsigned int mask_w, unsigned int mask_h,
+                        unsigned int img_w, unsigned int y_from,
+                        unsigned int y_to) {
+
+  for (unsigned int y = y_from; y != y_to; ++y) {
+    unsigned char *px = &img_grey[y * img_w];
+    const unsigned char *m = &mask[(y & (mask_h - 1)) * mask_w];
+
+    for (unsigned int x = 0; x != img_w; ++x) {
+      px[x] = px[x] <= m[x & (mask_w - 1)] ? 0x00 : 0xff;
+    }
+  }
+}
+
+/* threshold masks have no dependency between pixels, every thread takes
+   its own slice of rows */
+static void s_threshold_rows(unsigned char *img_grey, const unsigned char *mask,
+                             unsigned int mask_w, unsigned int mask_h,
+                             unsigned int img_w, unsigned int y_from,
+                             unsigned int y_to, unsigned int threads) {
+  unsigned int n = y_to - y_from;
+
+  if (threads < 2 || (size_t) n * img_w < 65536) {
+    s_threshold(img_grey, mask, mask_w, mask_h, img_w, y_from, y_to);
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  try {
+    for (unsigned int t = 1; t < threads; ++t) {
+      workers.push_back(std::thread(s_threshold, img_grey, mask, mask_w,
+                                    mask_h, img_w, y_from + n * t / threads,
+                                    y_from + n * (t + 1) / threads));
+    }
+  } catch (const std::system_error &) {
+  }
+  s_threshold(img_grey, mask, mask_w, mask_h, img_w, y_from,
+              y_from + n / threads);
+  /* the slices of threads that could not be started */
+  for (unsigned int t = workers.size() + 1; t < threads; ++t) {
+    s_threshold(img_grey, mask, mask_w, mask_h, img_w,
+                y_from + n * t / threads, y_from + n * (t + 1) / threads);
+  }
+  for (unsigned int t = 0; t != workers.size(); ++t) {
+    workers[t].join();
+  }
+}
+
+int png2pos_dither_from_name(const char *name) {
+  static const struct {
+    const char *name;
+    enum png2pos_dither method;
+  } names[] = {
+    { "jjn", PNG2POS_DITHER_JJN },
+    { "floyd-steinberg", PNG2POS_DITHER_FLOYD_STEINBERG },
+    { "atkinson", PNG2POS_DITHER_ATKINSON },
+    { "stucki", PNG2POS_DITHER_STUCKI },
+    { "sierra-lite", PNG2POS_DITHER_SIERRA_LITE },
+    { "bayer", PNG2POS_DITHER_BAYER },
+    { "blue-noise", PNG2POS_DITHER_BLUE_NOISE }
+  };
+
+  for (unsigned int i = 0; i != sizeof names / sizeof names[0]; ++i) {
+    if (!strcmp(name, names[i].name)) {
+      return names[i].method;
+    }
+  }
+  return -1;
+}
+
+size_t png2pos_dither_state_size(enum png2pos_dither method,
+                                 unsigned int img_w, unsigned int threads) {
+  switch (method) {
+  case PNG2POS_DITHER_BAYER:
+  case PNG2POS_DITHER_BLUE_NOISE:
+    return 0;
+
+  default:
+    return s_err_rows(threads) * (size_t) s_err_stride(img_w);
+  }
+}
+
+void png2pos_dither_rows(enum png2pos_dither method, unsigned char *img_grey,
+                         short *img_err, unsigned int img_w,
+                         unsigned int y_from, unsigned int y_to,
+                         unsigned int threads) {
+  switch (method) {
+  case PNG2POS_DITHER_FLOYD_STEINBERG:
+    s_diffuse_rows<floyd_steinberg_kernel>(img_grey, img_err, img_w, y_from,
+                                           y_to, threads);
+    break;
+
+  case PNG2POS_DITHER_ATKINSON:
+    s_diffuse_rows<atkinson_kernel>(img_grey, img_err, img_w, y_from,
+                                    y_to, threads);
+    break;
+
+  case PNG2POS_DITHER_STUCKI:
+    s_diffuse_rows<stucki_kernel>(img_grey, img_err, img_w, y_from,
+                                  y_to, threads);
+    break;
+
+  case PNG2POS_DITHER_SIERRA_LITE:
+    s_diffuse_rows<sierra_lite_kernel>(img_grey, img_err, img_w, y_from,
+                                       y_to, threads);
+    break;
+
+  case PNG2POS_DITHER_BAYER:
+    s_threshold_rows(img_grey, &bayer_mask[0][0], 8, 8, img_w, y_from, y_to,
+                     threads);
+    break;
+
+  case PNG2POS_DITHER_BLUE_NOISE:
+    s_threshold_rows(img_grey, &bluenoise_mask[0][0], 64, 64, img_w, y_from,
+                     y_to, threads);
+    break;
+
+  case PNG2POS_DITHER_JJN:
+  default:
+    s_diffuse_rows<jjn_kernel>(img_grey, img_err, img_w, y_from,
+                               y_to, threads);
+  }
+}
@@ -0,0 +1,43 @@
+/* png2pos_dither.h, grey → black/white dithering kernels for the png2pos
+   converter */
+
+#ifndef PNG2POS_DITHER_H
+#define PNG2POS_DITHER_H
+
+#include <stddef.h>
+
+enum png2pos_dither {
+  /* error diffusion */
+  PNG2POS_DITHER_JJN = 0,
+  PNG2POS_DITHER_FLOYD_STEINBERG,
+  PNG2POS_DITHER_ATKINSON,
+  PNG2POS_DITHER_STUCKI,
+  PNG2POS_DITHER_SIERRA_LITE,
+  /* threshold masks, no dependency between pixels */
+  PNG2POS_DITHER_BAYER,
+  PNG2POS_DITHER_BLUE_NOISE
+};
+
+/* dithering method for a name as used from R ("jjn", "floyd-steinberg",
+   "atkinson", "stucki", "sierra-lite", "bayer", "blue-noise");
+   returns -1 for an unknown name */
+int png2pos_dither_from_name(const char *name);
+
+/* number of shorts of error state png2pos_dither_rows() needs to dither an
+   image img_w pixels wide with the given number of threads; 0 for the
+   threshold mask methods */
+size_t png2pos_dither_state_size(enum png2pos_dither method,
+                                 unsigned int img_w, unsigned int threads);
+
+/* dither rows [y_from; y_to) of img_grey in place to 0x00 / 0xff; rows
+   have to be passed in order, img_err (png2pos_dither_state_size() shorts,
+   zeroed before the first row) carries the error from one call to the
+   next; with threads > 1 threshold masks are split into slices of rows
+   and error diffusion runs as a row-lagged wavefront, the result is the
+   same as with one thread */
+void png2pos_dither_rows(enum png2pos_dither method, unsigned char *img_grey,
+                         short *img_err, unsigned int img_w,
+                         unsigned int y_from, unsigned int y_to,
+                         unsigned int threads);
+
+#endif /* PNG2POS_DITHER_H */
@@ -0,0 +1,268 @@
+#include <string.h>
+#include "png2pos_grey.h"
+#include "png2pos_simd.h"
+
+/* the histogram is spread over several banks so that runs of equal
+   pixels (most of any plot) do not stall on the same counter */
+#define HIST_BANKS 4
+
+/* x / 255 for 0 <= x <= 255 * 255 */
+#define DIV255(x) (((x) + ((x) >> 8) + 1) >> 8)
+
+/* x / 255 rounded to nearest for 0 <= x <= 255 * 255 */
+#define DIV255_ROUND(x) (((x) + 128 + (((x) + 128) >> 8)) >> 8)
+
+/* v over the background at coverage a, in 8 bit fixed point:
+   (a * v + (255 - a) * bg) / 255, exact for opaque and clear pixels */
+static inline unsigned int s_over(unsigned int v, unsigned int a,
+                                  unsigned int bg) {
+  return DIV255_ROUND(a * v + (255 - a) * bg);
+}
+
+static inline unsigned char s_luminance(const unsigned char *p,
+                                        unsigned int bg) {
+  /* A */
+  unsigned int a = p[3];
+
+  /* RGBA → RGB → L* */
+  unsigned int r = s_over(p[0], a, bg);
+  unsigned int g = s_over(p[1], a, bg);
+  unsigned int b = s_over(p[2], a, bg);
+
+  return (55 * r + 182 * g + 18 * b) / 255;
+}
+
+static void s_grey_scalar(const unsigned char *rgba, unsigned char *grey,
+                          size_t from, size_t n, unsigned int bg,
+                          unsigned int hist[HIST_BANKS][256]) {
+  for (size_t i = from; i != n; ++i) {
+    grey[i] = s_luminance(&rgba[i << 2], bg);
+    ++hist[i & (HIST_BANKS - 1)][grey[i]];
+  }
+}
+
+static inline void s_count16(const unsigned char *g,
+                             unsigned int hist[HIST_BANKS][256]) {
+  for (unsigned int j = 0; j != 16; j += HIST_BANKS) {
+    ++hist[0][g[j]];
+    ++hist[1][g[j + 1]];
+    ++hist[2][g[j + 2]];
+    ++hist[3][g[j + 3]];
+  }
+}
+
+#ifdef PNG2POS_SSE2
+/* s_over on 8 lanes, back holding (255 - a) * bg + 128 */
+static inline __m128i s_over_sse2(__m128i v, __m128i a, __m128i back) {
+  __m128i x = _mm_add_epi16(_mm_mullo_epi16(a, v), back);
+  return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+/* 8 RGBA pixels → 8 L* values in the low bytes of 16 bit lanes */
+static inline __m128i s_luminance8_sse2(__m128i p0, __m128i p1,
+                                        __m128i bg) {
+  const __m128i m8 = _mm_set1_epi32(0xff);
+  const __m128i c255 = _mm_set1_epi16(255);
+
+  __m128i r = _mm_packs_epi32(_mm_and_si128(p0, m8),
+                              _mm_and_si128(p1, m8));
+  __m128i g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 8), m8),
+                              _mm_and_si128(_mm_srli_epi32(p1, 8), m8));
+  __m128i b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 16), m8),
+                              _mm_and_si128(_mm_srli_epi32(p1, 16), m8));
+  __m128i a = _mm_packs_epi32(_mm_srli_epi32(p0, 24),
+                              _mm_srli_epi32(p1, 24));
+
+  /* a * v + (255 - a) * bg + 128 stays below 2^16, so the blend and the
+     rounded division by 255 fit unsigned 16 bit lanes */
+  const __m128i c128 = _mm_set1_epi16(128);
+  __m128i back = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(c255, a), bg),
+                               c128);
+
+  r = s_over_sse2(r, a, back);
+  g = s_over_sse2(g, a, back);
+  b = s_over_sse2(b, a, back);
+
+  __m128i l = _mm_add_epi16(
+    _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(55)),
+                  _mm_mullo_epi16(g, _mm_set1_epi16(182))),
+    _mm_mullo_epi16(b, _mm_set1_epi16(18)));
+
+  return _mm_srli_epi16(
+    _mm_add_epi16(_mm_add_epi16(l, _mm_srli_epi16(l, 8)),
+                  _mm_set1_epi16(1)), 8);
+}
+
+static size_t s_grey_sse2(const unsigned char *rgba, unsigned char *grey,
+                          size_t n, unsigned int bg,
+                          unsigned int hist[HIST_BANKS][256]) {
+  const __m128i bg16 = _mm_set1_epi16((short)bg);
+  size_t i = 0;
+
+  for (; i + 16 <= n; i += 16) {
+    const __m128i *src = (const __m128i *)&rgba[i << 2];
+
+    __m128i lo = s_luminance8_sse2(_mm_loadu_si128(src),
+                                   _mm_loadu_si128(src + 1), bg16);
+    __m128i hi = s_luminance8_sse2(_mm_loadu_si128(src + 2),
+                                   _mm_loadu_si128(src + 3), bg16);
+
+    _mm_storeu_si128((__m128i *)&grey[i], _mm_packus_epi16(lo, hi));
+    s_count16(&grey[i], hist);
+  }
+
+  return i;
+}
+#endif
+
+#ifdef PNG2POS_AVX2
+/* s_over on 16 lanes, back holding (255 - a) * bg + 128 */
+PNG2POS_TARGET_AVX2
+static inline __m256i s_over_avx2(__m256i v, __m256i a, __m256i back) {
+  __m256i x = _mm256_add_epi16(_mm256_mullo_epi16(a, v), back);
+  return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+/* 16 RGBA pixels → 16 L* values in the low bytes of 16 bit lanes */
+PNG2POS_TARGET_AVX2
+static inline __m256i s_luminance16_avx2(__m256i p0, __m256i p1,
+                                         __m256i bg) {
+  const __m256i m8 = _mm256_set1_epi32(0xff);
+  const __m256i c255 = _mm256_set1_epi16(255);
+
+  /* packing works per 128 bit lane, put pixels back in order */
+#define PACK32(x, y) _mm256_permute4x64_epi64(_mm256_packus_epi32(x, y), 0xd8)
+  __m256i r = PACK32(_mm256_and_si256(p0, m8), _mm256_and_si256(p1, m8));
+  __m256i g = PACK32(_mm256_and_si256(_mm256_srli_epi32(p0, 8), m8),
+                     _mm256_and_si256(_mm256_srli_epi32(p1, 8), m8));
+  __m256i b = PACK32(_mm256_and_si256(_mm256_srli_epi32(p0, 16), m8),
+                     _mm256_and_si256(_mm256_srli_epi32(p1, 16), m8));
+  __m256i a = PACK32(_mm256_srli_epi32(p0, 24), _mm256_srli_epi32(p1, 24));
+#undef PACK32
+
+  /* as in s_luminance8_sse2, the blend fits unsigned 16 bit lanes */
+  const __m256i c128 = _mm256_set1_epi16(128);
+  __m256i back = _mm256_add_epi16(
+    _mm256_mullo_epi16(_mm256_sub_epi16(c255, a), bg), c128);
+
+  r = s_over_avx2(r, a, back);
+  g = s_over_avx2(g, a, back);
+  b = s_over_avx2(b, a, back);
+
+  __m256i l = _mm256_add_epi16(
+    _mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(55)),
+                     _mm256_mullo_epi16(g, _mm256_set1_epi16(182))),
+    _mm256_mullo_epi16(b, _mm256_set1_epi16(18)));
+
+  return _mm256_srli_epi16(
+    _mm256_add_epi16(_mm256_add_epi16(l, _mm256_srli_epi16(l, 8)),
+                     _mm256_set1_epi16(1)), 8);
+}
+
+PNG2POS_TARGET_AVX2
+static size_t s_grey_avx2(const unsigned char *rgba, unsigned char *grey,
+                          size_t n, unsigned int bg,
+                          unsigned int hist[HIST_BANKS][256]) {
+  const __m256i bg16 = _mm256_set1_epi16((short)bg);
+  size_t i = 0;
+
+  for (; i + 32 <= n; i += 32) {
+    const __m256i *src = (const __m256i *)&rgba[i << 2];
+
+    __m256i lo = s_luminance16_avx2(_mm256_loadu_si256(src),
+                                    _mm256_loadu_si256(src + 1), bg16);
+    __m256i hi = s_luminance16_avx2(_mm256_loadu_si256(src + 2),
+                                    _mm256_loadu_si256(src + 3), bg16);
+
+    _mm256_storeu_si256((__m256i *)&grey[i], _mm256_permute4x64_epi64(
+      _mm256_packus_epi16(lo, hi), 0xd8));
+    s_count16(&grey[i], hist);
+    s_count16(&grey[i + 16], hist);
+  }
+
+  return i;
+}
+#endif
+
+void png2pos_rgba_to_grey(const unsigned char *rgba, unsigned char *grey,
+                          size_t n, unsigned char background,
+                          unsigned int histogram[256]) {
+  unsigned int hist[HIST_BANKS][256];
+  memset(hist, 0, sizeof hist);
+
+  size_t done = 0;
+
+#if defined(PNG2POS_AVX2)
+  if (png2pos_have_avx2()) {
+    done = s_grey_avx2(rgba, grey, n, background, hist);
+  } else {
+    done = s_grey_sse2(rgba, grey, n, background, hist);
+  }
+#elif defined(PNG2POS_SSE2)
+  done = s_grey_sse2(rgba, grey, n, background, hist);
+#endif
+
+  s_grey_scalar(rgba, grey, done, n, background, hist);
+
+  for (unsigned int i = 0; i != 256; ++i) {
+    histogram[i] += hist[0][i] + hist[1][i] + hist[2][i] + hist[3][i];
+  }
+}
+
+void png2pos_palette_to_grey(const unsigned char *palette, unsigned int n,
+                             unsigned char background,
+                             unsigned char lut[256]) {
+  unsigned int hist[256] = { 0 };
+
+  memset(lut, 0, 256);
+  png2pos_rgba_to_grey(palette, lut, n > 256 ? 256 : n, background, hist);
+}
+
+void png2pos_index_to_grey(const unsigned char *index, unsigned int depth,
+                           unsigned char *grey, size_t n,
+                           const unsigned char lut[256],
+                           unsigned int histogram[256]) {
+  unsigned int hist[HIST_BANKS][256];
+  memset(hist, 0, sizeof hist);
+
+  if (depth == 8) {
+    for (size_t i = 0; i != n; ++i) {
+      grey[i] = lut[index[i]];
+      ++hist[i & (HIST_BANKS - 1)][grey[i]];
+    }
+  } else {
+    /* all pixels of a byte at once, most significant first */
+    const unsigned int per_byte = 8 / depth;
+    const unsigned int mask = (1u << depth) - 1;
+    size_t i = 0;
+
+    for (size_t j = 0; i < n; ++j) {
+      unsigned int byte = index[j];
+
+      for (unsigned int k = 0; k != per_byte && i < n; ++k, ++i) {
+        grey[i] = lut[byte >> (8 - depth * (k + 1)) & mask];
+        ++hist[i & (HIST_BANKS - 1)][grey[i]];
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i != 256; ++i) {
+    histogram[i] += hist[0][i] + hist[1][i] + hist[2][i] + hist[3][i];
+  }
+}
+
+void png2pos_grey_alpha_to_grey(const unsigned char *ga, unsigned char *grey,
+                                size_t n, unsigned char background,
+                                unsigned int histogram[256]) {
+  unsigned int hist[HIST_BANKS][256];
+  memset(hist, 0, sizeof hist);
+
+  for (size_t i = 0; i != n; ++i) {
+    grey[i] = s_over(ga[i << 1], ga[(i << 1) + 1], background);
+    ++hist[i & (HIST_BANKS - 1)][grey[i]];
+  }
+
+  for (unsigned int i = 0; i != 256; ++i) {
+    histogram[i] += hist[0][i] + hist[1][i] + hist[2][i] + hist[3][i];
+  }
+}
@@ -0,0 +1,42 @@
+/* png2pos_grey.h, pixel → L* conversion kernels for the png2pos converter
+
+   Images are decoded in their own colour type where it allows: grey
+   levels already are L* (the weights of the RGB → L* step add up to 255),
+   palette and low bit depth images are looked up through a table of at
+   most 256 levels, and only true colour images are expanded to RGBA. */
+
+#ifndef PNG2POS_GREY_H
+#define PNG2POS_GREY_H
+
+#include <stddef.h>
+
+/* convert n RGBA pixels, composited over a grey background level, to L*
+   and count them into histogram[256]; grey may point to the start of rgba (pixel i is stored to byte i only
+   after bytes 4i..4i+3 have been read), so the conversion can run in place;
+   uses AVX2 or SSE2 where the CPU has them, plain C otherwise */
+void png2pos_rgba_to_grey(const unsigned char *rgba, unsigned char *grey,
+                          size_t n, unsigned char background,
+                          unsigned int histogram[256]);
+
+/* lut[i] for the n <= 256 RGBA colours of a palette, each as
+   png2pos_rgba_to_grey() would convert it; entries past n are black, as
+   lodepng decodes indexes missing from the palette */
+void png2pos_palette_to_grey(const unsigned char *palette, unsigned int n,
+                             unsigned char background,
+                             unsigned char lut[256]);
+
+/* look up n pixels of depth bits (1, 2, 4 or 8; packed most significant
+   bit first, no padding between rows) in lut into grey and count them into
+   histogram[256]; with depth 8, grey may be index */
+void png2pos_index_to_grey(const unsigned char *index, unsigned int depth,
+                           unsigned char *grey, size_t n,
+                           const unsigned char lut[256],
+                           unsigned int histogram[256]);
+
+/* n grey + alpha pixels over the background, as png2pos_rgba_to_grey();
+   grey may point to the start of ga */
+void png2pos_grey_alpha_to_grey(const unsigned char *ga, unsigned char *grey,
+                                size_t n, unsigned char background,
+                                unsigned int histogram[256]);
+
+#endif /* PNG2POS_GREY_H */
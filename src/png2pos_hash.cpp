@@ -0,0 +1,12 @@
+#include "png2pos_hash.h"
+
+uint64_t png2pos_hash(const void *p, size_t n, uint64_t h) {
+  const unsigned char *b = (const unsigned char *)p;
+
+  for (size_t i = 0; i != n; ++i) {
+    h ^= b[i];
+    h *= 0x100000001b3ull;
+  }
+
+  return h;
+}
@@ -0,0 +1,15 @@
+/* png2pos_hash.h, content hashes for telling images apart */
+
+#ifndef PNG2POS_HASH_H
+#define PNG2POS_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* 64 bit FNV-1a hash of n bytes, continuing from h (start with
+   PNG2POS_HASH_INIT) */
+#define PNG2POS_HASH_INIT 0xcbf29ce484222325ull
+
+uint64_t png2pos_hash(const void *p, size_t n, uint64_t h);
+
+#endif /* PNG2POS_HASH_H */
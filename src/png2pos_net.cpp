@@ -0,0 +1,251 @@
+#include <stdio.h>
+#include <string.h>
+#include "png2pos_net.h"
+#include "png2pos_sink.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+typedef SOCKET s_socket;
+#define INVALID(fd) ((fd) == INVALID_SOCKET)
+#define CLOSE_SOCKET closesocket
+#define SHUT_WR SD_SEND
+#else
+typedef int s_socket;
+#define INVALID(fd) ((fd) < 0)
+#define CLOSE_SOCKET close
+#endif
+
+/* connect fd to addr, waiting at most timeout seconds (0 = as long as the
+   system does); returns 0 on success, -1 if the time ran out, otherwise
+   the error code */
+static int s_connect(s_socket fd, const struct sockaddr *addr,
+                     socklen_t addr_len, unsigned int timeout) {
+  if (!timeout) {
+#ifdef _WIN32
+    return connect(fd, addr, (int)addr_len) ? WSAGetLastError() : 0;
+#else
+    return connect(fd, addr, addr_len) ? errno : 0;
+#endif
+  }
+
+  /* started without blocking, then waited for until it is writable */
+#ifdef _WIN32
+  u_long on = 1;
+  ioctlsocket(fd, FIONBIO, &on);
+
+  if (connect(fd, addr, (int)addr_len)) {
+    int rc = WSAGetLastError();
+    if (rc != WSAEWOULDBLOCK) {
+      return rc;
+    }
+
+    fd_set writable, failed;
+    FD_ZERO(&writable);
+    FD_ZERO(&failed);
+    FD_SET(fd, &writable);
+    FD_SET(fd, &failed);
+    struct timeval tv;
+    tv.tv_sec = timeout;
+    tv.tv_usec = 0;
+
+    rc = select(0, NULL, &writable, &failed, &tv);
+    if (rc <= 0) {
+      return rc ? WSAGetLastError() : -1;
+    }
+  }
+#else
+  int flags = fcntl(fd, F_GETFL, 0);
+  fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+  if (connect(fd, addr, addr_len)) {
+    if (errno != EINPROGRESS) {
+      return errno;
+    }
+
+    struct pollfd p;
+    p.fd = fd;
+    p.events = POLLOUT;
+    p.revents = 0;
+
+    int ms = timeout > 2000000u ? 2000000000 : (int)timeout * 1000;
+    int rc;
+    do {
+      rc = poll(&p, 1, ms);
+    } while (rc < 0 && errno == EINTR);
+    if (rc <= 0) {
+      return rc ? errno : -1;
+    }
+  }
+#endif
+
+  /* whether it came through or was refused */
+  int error = 0;
+  socklen_t len = sizeof error;
+  if (getsockopt(fd, SOL_SOCKET, SO_ERROR, (char *)&error, &len)) {
+#ifdef _WIN32
+    return WSAGetLastError();
+#else
+    return errno;
+#endif
+  }
+  if (error) {
+    return error;
+  }
+
+  /* blocking again, sends are bounded by SO_SNDTIMEO */
+#ifdef _WIN32
+  on = 0;
+  ioctlsocket(fd, FIONBIO, &on);
+#else
+  fcntl(fd, F_SETFL, flags);
+#endif
+  return 0;
+}
+
+intptr_t png2pos_connect(const char *host, const char *port,
+                         unsigned int timeout, char *error) {
+#ifdef _WIN32
+  /* reference counted, undone in png2pos_disconnect() */
+  WSADATA wsa;
+  if (WSAStartup(MAKEWORD(2, 2), &wsa)) {
+    snprintf(error, 256, "could not start Windows sockets");
+    return -1;
+  }
+#endif
+
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof hints);
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_protocol = IPPROTO_TCP;
+
+  struct addrinfo *found = NULL;
+  int rc = getaddrinfo(host, port, &hints, &found);
+  if (rc) {
+    snprintf(error, 256, "could not resolve %s: %s", host, gai_strerror(rc));
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    return -1;
+  }
+
+  intptr_t s = -1;
+  int rc_connect = 0;
+
+  for (struct addrinfo *a = found; a; a = a->ai_next) {
+    s_socket fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+    if (INVALID(fd)) {
+      continue;
+    }
+    rc_connect = s_connect(fd, a->ai_addr, (socklen_t)a->ai_addrlen,
+                           timeout);
+    if (!rc_connect) {
+      s = (intptr_t)fd;
+      break;
+    }
+    CLOSE_SOCKET(fd);
+  }
+  freeaddrinfo(found);
+
+  if (s == -1) {
+    if (rc_connect == -1) {
+      snprintf(error, 256, "could not connect to %s port %s: no answer "
+               "within %u seconds", host, port, timeout);
+    } else if (rc_connect) {
+      char why[256];
+      png2pos_send_error((unsigned int)rc_connect, why);
+      snprintf(error, 256, "could not connect to %s port %s: %.128s", host,
+               port, why);
+    } else {
+      snprintf(error, 256, "could not connect to %s port %s", host, port);
+    }
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    return -1;
+  }
+
+  /* the sink gathers small commands itself, Nagle would only hold back
+     the tail of the job */
+  int on = 1;
+  setsockopt((s_socket)s, IPPROTO_TCP, TCP_NODELAY, (const char *)&on,
+             sizeof on);
+
+  /* a printer out of paper stops reading; give up rather than hang */
+  if (timeout) {
+#ifdef _WIN32
+    DWORD ms = timeout * 1000;
+    setsockopt((s_socket)s, SOL_SOCKET, SO_SNDTIMEO, (const char *)&ms,
+               sizeof ms);
+#else
+    struct timeval tv;
+    tv.tv_sec = timeout;
+    tv.tv_usec = 0;
+    setsockopt((s_socket)s, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof tv);
+#endif
+  }
+
+  return s;
+}
+
+void png2pos_send_error(unsigned int code, char *error) {
+  if (code == PNG2POS_SINK_FAILED) {
+    snprintf(error, 256, "connection lost while sending");
+    return;
+  }
+
+#ifdef _WIN32
+  /* SO_SNDTIMEO ran out: the printer stopped taking data */
+  if (code == WSAETIMEDOUT) {
+    snprintf(error, 256, "the printer stopped taking data");
+    return;
+  }
+
+  /* strerror() does not know the Windows sockets codes */
+  if (!FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM
+                      | FORMAT_MESSAGE_IGNORE_INSERTS, NULL, code, 0, error,
+                      256, NULL)) {
+    snprintf(error, 256, "Windows sockets error %u", code);
+    return;
+  }
+
+  /* the system messages end in a line break */
+  size_t n = strlen(error);
+  while (n && (error[n - 1] == '\n' || error[n - 1] == '\r' ||
+               error[n - 1] == '.')) {
+    error[--n] = 0;
+  }
+#else
+  if (code == EAGAIN || code == EWOULDBLOCK) {
+    snprintf(error, 256, "the printer stopped taking data");
+    return;
+  }
+
+  snprintf(error, 256, "%s", strerror((int)code));
+#endif
+}
+
+void png2pos_disconnect(intptr_t s) {
+  if (s == -1) {
+    return;
+  }
+  shutdown((s_socket)s, SHUT_WR);
+  CLOSE_SOCKET((s_socket)s);
+#ifdef _WIN32
+  WSACleanup();
+#endif
+}
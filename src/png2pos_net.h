@@ -0,0 +1,27 @@
+/* png2pos_net.h, TCP connections to network printers
+
+   ESC/POS network printers take the raw stream on a plain TCP port (9100,
+   "JetDirect"). Together with a socket sink (png2pos_sink.h) the converter
+   sends every band as soon as it is packed, so the printer starts on the
+   first band while the rest of the image is still being converted. */
+
+#ifndef PNG2POS_NET_H
+#define PNG2POS_NET_H
+
+#include <stdint.h>
+
+/* connect to port on host (name or address); sends block for at most
+   timeout seconds (0 = no limit); returns the socket, or -1 with a
+   message in error (at least 256 bytes) */
+intptr_t png2pos_connect(const char *host, const char *port,
+                         unsigned int timeout, char *error);
+
+/* what went wrong sending on a socket sink, from its error
+   (png2pos_sink_flush()), in error (at least 256 bytes) */
+void png2pos_send_error(unsigned int code, char *error);
+
+/* end the job and close a socket from png2pos_connect(); what was sent
+   is still delivered */
+void png2pos_disconnect(intptr_t s);
+
+#endif /* PNG2POS_NET_H */
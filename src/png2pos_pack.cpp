@@ -0,0 +1,267 @@
+#include <stdint.h>
+#include <string.h>
+#include "png2pos_pack.h"
+#include "png2pos_simd.h"
+
+/* bytes of either side of the tiles a bitmap is rotated in */
+#ifndef ROTATE_TILE
+#define ROTATE_TILE 8u
+#endif
+
+/* bit order of every byte reversed */
+static const unsigned char bit_reverse[256] = {
+#define R2(n) n, n + 2 * 64, n + 1 * 64, n + 3 * 64
+#define R4(n) R2(n), R2(n + 2 * 16), R2(n + 1 * 16), R2(n + 3 * 16)
+#define R6(n) R4(n), R4(n + 2 * 4), R4(n + 1 * 4), R4(n + 3 * 4)
+  R6(0), R6(2), R6(1), R6(3)
+#undef R6
+#undef R4
+#undef R2
+};
+
+/* 8 pixels → 1 byte, pixel 0 in the most significant bit */
+static inline unsigned char s_pack8(const unsigned char *g) {
+  return (g[0] <= 0x80) << 7 | (g[1] <= 0x80) << 6 | (g[2] <= 0x80) << 5
+       | (g[3] <= 0x80) << 4 | (g[4] <= 0x80) << 3 | (g[5] <= 0x80) << 2
+       | (g[6] <= 0x80) << 1 | (g[7] <= 0x80);
+}
+
+#ifdef PNG2POS_SSE2
+/* 16 pixels → 2 bytes: min(v, 0x80) == v marks the black ones, movemask
+   collects them with pixel 0 in bit 0, the table flips every byte */
+static unsigned int s_pack_sse2(const unsigned char *grey, unsigned int n,
+                                unsigned char *bits) {
+  const __m128i c80 = _mm_set1_epi8((char)0x80);
+  unsigned int x = 0;
+
+  for (; x + 16 <= n; x += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)&grey[x]);
+    unsigned int m = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(v, c80), v));
+
+    bits[(x >> 3)] = bit_reverse[m & 0xff];
+    bits[(x >> 3) + 1] = bit_reverse[m >> 8];
+  }
+
+  return x;
+}
+#endif
+
+#ifdef PNG2POS_AVX2
+PNG2POS_TARGET_AVX2
+static unsigned int s_pack_avx2(const unsigned char *grey, unsigned int n,
+                                unsigned char *bits) {
+  const __m256i c80 = _mm256_set1_epi8((char)0x80);
+  unsigned int x = 0;
+
+  for (; x + 32 <= n; x += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)&grey[x]);
+    unsigned int m = _mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(_mm256_min_epu8(v, c80), v));
+
+    bits[(x >> 3)] = bit_reverse[m & 0xff];
+    bits[(x >> 3) + 1] = bit_reverse[(m >> 8) & 0xff];
+    bits[(x >> 3) + 2] = bit_reverse[(m >> 16) & 0xff];
+    bits[(x >> 3) + 3] = bit_reverse[m >> 24];
+  }
+
+  return x;
+}
+#endif
+
+void png2pos_pack_row(const unsigned char *grey, unsigned int img_w,
+                      unsigned char *bits) {
+  unsigned int x = 0;
+
+#if defined(PNG2POS_AVX2)
+  if (png2pos_have_avx2()) {
+    x = s_pack_avx2(grey, img_w, bits);
+  }
+  x += s_pack_sse2(&grey[x], img_w - x, &bits[x >> 3]);
+#elif defined(PNG2POS_SSE2)
+  x = s_pack_sse2(grey, img_w, bits);
+#endif
+
+  for (; x + 8 <= img_w; x += 8) {
+    bits[x >> 3] = s_pack8(&grey[x]);
+  }
+
+  if (x < img_w) {
+    unsigned char last = 0;
+    for (unsigned int i = 0; x + i < img_w; ++i) {
+      last |= (grey[x + i] <= 0x80) << (7 - i);
+    }
+    bits[x >> 3] = last;
+  }
+}
+
+/* 8 bytes, the first in the most significant place */
+static inline uint64_t s_load64(const unsigned char *p) {
+  return (uint64_t)p[0] << 56 | (uint64_t)p[1] << 48 | (uint64_t)p[2] << 40
+       | (uint64_t)p[3] << 32 | (uint64_t)p[4] << 24 | (uint64_t)p[5] << 16
+       | (uint64_t)p[6] << 8 | (uint64_t)p[7];
+}
+
+static inline void s_store64(unsigned char *p, uint64_t x) {
+  for (unsigned int i = 0; i != 8; ++i) {
+    p[i] = (unsigned char)(x >> (56 - 8 * i));
+  }
+}
+
+void png2pos_repack_row(const unsigned char *src, size_t from,
+                        unsigned int nbits, unsigned int black0,
+                        unsigned int black1, unsigned char *dst) {
+  const unsigned char *p = &src[from >> 3];
+  const unsigned int s = from & 7;
+  const unsigned int n = (nbits + 7) >> 3;
+
+  /* bytes of src the row touches, one more than n where it is not
+     byte aligned */
+  const size_t avail = (s + nbits + 7) >> 3;
+
+  /* dot = bit & set | ~bit & clear */
+  const uint64_t set = black1 ? ~(uint64_t)0 : 0;
+  const uint64_t clear = black0 ? ~(uint64_t)0 : 0;
+  unsigned int i = 0;
+
+  /* 64 dots at a time, shifted into place with the next byte */
+  for (; i + 8 < avail && i + 8 <= n; i += 8) {
+    uint64_t x = s_load64(&p[i]);
+
+    if (s) {
+      x = x << s | p[i + 8] >> (8 - s);
+    }
+    s_store64(&dst[i], (x & set) | (~x & clear));
+  }
+
+  for (; i != n; ++i) {
+    unsigned int x = p[i] << s;
+
+    if (s && i + 1 < avail) {
+      x |= p[i + 1] >> (8 - s);
+    }
+    dst[i] = (unsigned char)((x & set) | (~x & clear));
+  }
+
+  if (nbits & 7) {
+    dst[n - 1] &= 0xff << (8 - (nbits & 7));
+  }
+}
+
+void png2pos_reverse_row(unsigned char *bits, unsigned int nbits) {
+  unsigned int n = (nbits + 7) >> 3;
+
+  /* mirror whole bytes ... */
+  for (unsigned int i = 0, j = n - 1; i < j; ++i, --j) {
+    unsigned char t = bit_reverse[bits[i]];
+    bits[i] = bit_reverse[bits[j]];
+    bits[j] = t;
+  }
+  if (n & 1) {
+    bits[n >> 1] = bit_reverse[bits[n >> 1]];
+  }
+
+  /* ... which leaves the zero padding of the last byte in front */
+  unsigned int pad = (n << 3) - nbits;
+  if (pad) {
+    for (unsigned int i = 0; i + 1 < n; ++i) {
+      bits[i] = bits[i] << pad | bits[i + 1] >> (8 - pad);
+    }
+    bits[n - 1] <<= pad;
+  }
+}
+
+void png2pos_place_row(unsigned char *dst, unsigned int offset,
+                       const unsigned char *bits, unsigned int nbits) {
+  unsigned int n = (nbits + 7) >> 3;
+  unsigned int r = offset & 7;
+
+  dst += offset >> 3;
+
+  if (!r) {
+    for (unsigned int i = 0; i != n; ++i) {
+      dst[i] |= bits[i];
+    }
+    return;
+  }
+
+  /* bits past nbits are 0, so the spill into dst[n] never sets a dot
+     beyond the row */
+  dst[0] |= bits[0] >> r;
+  for (unsigned int i = 1; i != n; ++i) {
+    dst[i] |= bits[i - 1] << (8 - r) | bits[i] >> r;
+  }
+  if (((offset + nbits + 7) >> 3) > (offset >> 3) + n) {
+    dst[n] |= bits[n - 1] << (8 - r);
+  }
+}
+
+/* 8x8 bit matrix transpose, row i in byte 7 - i of x, most significant
+   bit first (Hacker's Delight 7-3) */
+static inline uint64_t s_transpose8(uint64_t x) {
+  uint64_t t;
+
+  t = (x ^ (x >> 7)) & 0x00aa00aa00aa00aaULL;
+  x ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000cccc0000ccccULL;
+  x ^= t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000f0f0f0f0ULL;
+  x ^= t ^ (t << 28);
+
+  return x;
+}
+
+void png2pos_rotate_bits(const unsigned char *src, unsigned int w,
+                         unsigned int h, unsigned int ccw,
+                         unsigned char *dst) {
+  const unsigned int src_bytes = (w + 7) >> 3;
+  const unsigned int dst_bytes = (h + 7) >> 3;
+
+  /* clockwise, source row y lands in destination column h - 1 - y; the
+     source is read as if padded with white rows on top to a multiple of
+     8, so every group of 8 rows fills one destination byte */
+  const unsigned int pad = ccw ? 0 : (dst_bytes << 3) - h;
+
+  /* tiles of ROTATE_TILE x ROTATE_TILE bytes keep the rows read and the
+     rows written in cache */
+  for (unsigned int g0 = 0; g0 < dst_bytes; g0 += ROTATE_TILE) {
+    unsigned int g1 = g0 + ROTATE_TILE < dst_bytes ? g0 + ROTATE_TILE
+                                                   : dst_bytes;
+
+    for (unsigned int b0 = 0; b0 < src_bytes; b0 += ROTATE_TILE) {
+      unsigned int b1 = b0 + ROTATE_TILE < src_bytes ? b0 + ROTATE_TILE
+                                                     : src_bytes;
+
+      for (unsigned int g = g0; g != g1; ++g) {
+        /* destination byte, and the first source row, of this group */
+        unsigned int d = ccw ? g : dst_bytes - 1 - g;
+        int y0 = (int)(g << 3) - (int)pad;
+
+        for (unsigned int b = b0; b != b1; ++b) {
+          uint64_t x = 0;
+
+          /* clockwise the rows go in bottom first, so each destination
+             byte comes out mirrored as it should */
+          for (unsigned int j = 0; j != 8; ++j) {
+            int y = y0 + (int)(ccw ? j : 7 - j);
+
+            if (y >= 0 && y < (int)h) {
+              x |= (uint64_t)src[(size_t)y * src_bytes + b] << (56 - 8 * j);
+            }
+          }
+
+          x = s_transpose8(x);
+
+          for (unsigned int i = 0; i != 8; ++i) {
+            unsigned int c = (b << 3) + i;
+
+            if (c >= w) {
+              break;
+            }
+            unsigned int row = ccw ? w - 1 - c : c;
+            dst[(size_t)row * dst_bytes + d] = (unsigned char)(x >> (56 - 8 * i));
+          }
+        }
+      }
+    }
+  }
+}
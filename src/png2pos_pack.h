@@ -0,0 +1,38 @@
+/* png2pos_pack.h, grey → 1 bit per dot packing for the png2pos converter */
+
+#ifndef PNG2POS_PACK_H
+#define PNG2POS_PACK_H
+
+#include <stddef.h>
+
+/* pack img_w grey pixels into (img_w + 7) / 8 bytes, most significant bit
+   first; a bit is set (black dot) where the pixel is <= 0x80, bits past
+   img_w in the last byte are 0 */
+void png2pos_pack_row(const unsigned char *grey, unsigned int img_w,
+                      unsigned char *bits);
+
+/* take nbits bits of a 1 bit image starting at bit from of src (most
+   significant bit first, rows not padded) into dst as a packed row: a
+   dot is set where the source bit is 0 and black0, or 1 and black1; bits
+   past nbits in the last byte are 0 */
+void png2pos_repack_row(const unsigned char *src, size_t from,
+                        unsigned int nbits, unsigned int black0,
+                        unsigned int black1, unsigned char *dst);
+
+/* mirror the first nbits bits of a packed row in place (one row of a 180°
+   rotation); bits past nbits in the last byte are 0 afterwards */
+void png2pos_reverse_row(unsigned char *bits, unsigned int nbits);
+
+/* turn a packed w x h bitmap (h rows of (w + 7) / 8 bytes, bits past w
+   0) a quarter clockwise, or counter-clockwise if ccw, into dst, w rows of
+   (h + 7) / 8 bytes with bits past h 0 */
+void png2pos_rotate_bits(const unsigned char *src, unsigned int w,
+                         unsigned int h, unsigned int ccw,
+                         unsigned char *dst);
+
+/* OR the first nbits bits of a packed row into dst, starting at bit offset
+   of dst */
+void png2pos_place_row(unsigned char *dst, unsigned int offset,
+                       const unsigned char *bits, unsigned int nbits);
+
+#endif /* PNG2POS_PACK_H */
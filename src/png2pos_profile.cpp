@@ -0,0 +1,55 @@
+#include <string.h>
+#include "png2pos_profile.h"
+
+#define ALL_RASTERS (PNG2POS_RASTER_BIT(PNG2POS_RASTER_GS8L) \
+                     | PNG2POS_RASTER_BIT(PNG2POS_RASTER_GSV0) \
+                     | PNG2POS_RASTER_BIT(PNG2POS_RASTER_COLUMN))
+
+static const struct png2pos_profile profiles[] = {
+  /* Epson TM-T88IV/V/VI, TM-T70; 80 mm paper, 72 mm printed */
+  { "tm-t88", 512, 180, 1662, ALL_RASTERS, 4096, 300 },
+  /* Epson TM-T20 family, 80 mm paper at 203 dpi */
+  { "tm-t20", 576, 203, 1662, ALL_RASTERS, 4096, 150 },
+  /* Epson TM-J2000/J2100 inkjet, takes GS 8 L bands of 128 rows at most */
+  { "tm-j2100", 512, 180, 128, ALL_RASTERS, 4096, 40 },
+  /* generic 58 mm printers, most of which know neither GS 8 L nor
+     GS ( L and have small buffers */
+  { "58mm", 384, 203, 1662,
+    PNG2POS_RASTER_BIT(PNG2POS_RASTER_GSV0)
+    | PNG2POS_RASTER_BIT(PNG2POS_RASTER_COLUMN), 2048, 90 }
+};
+
+unsigned int png2pos_profile_count(void) {
+  return sizeof profiles / sizeof profiles[0];
+}
+
+const struct png2pos_profile *png2pos_profile_at(unsigned int i) {
+  return i < png2pos_profile_count() ? &profiles[i] : NULL;
+}
+
+const struct png2pos_profile *png2pos_profile_find(const char *name) {
+  for (unsigned int i = 0; i != png2pos_profile_count(); ++i) {
+    if (!strcmp(name, profiles[i].name)) {
+      return &profiles[i];
+    }
+  }
+  return NULL;
+}
+
+void png2pos_profile_apply(const struct png2pos_profile *profile,
+                           struct png2pos_options *opt) {
+  opt->printer_max_width = profile->width & ~0x7u;
+  opt->dpi = profile->dpi;
+  opt->gs8l_max_y = profile->gs8l_max_y;
+  opt->buffer = profile->buffer;
+  opt->speed = profile->speed;
+
+  if (!(profile->rasters & PNG2POS_RASTER_BIT(opt->raster))) {
+    for (unsigned int r = 0; r != 32; ++r) {
+      if (profile->rasters & PNG2POS_RASTER_BIT(r)) {
+        opt->raster = (enum png2pos_raster)r;
+        break;
+      }
+    }
+  }
+}
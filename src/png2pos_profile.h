@@ -0,0 +1,44 @@
+/* png2pos_profile.h, printer profiles for the png2pos converter
+
+   A profile holds what the converter needs to know about one printer
+   model: how many dots fit across the paper, how tall a GS 8 L band may
+   be, which raster command sets it takes and how large its receive buffer
+   is. Profiles are chosen per conversion, so one process can drive a mix
+   of printers. */
+
+#ifndef PNG2POS_PROFILE_H
+#define PNG2POS_PROFILE_H
+
+#include "png2pos_convert.h"
+
+struct png2pos_profile {
+  const char *name;
+  unsigned int width; /* printable dots across the paper, divisible by 8 */
+  unsigned int dpi; /* dots per inch, both directions; the ESC J feed unit
+                       is set to match (GS P) */
+  unsigned int gs8l_max_y; /* rows per GS 8 L band */
+  unsigned int rasters; /* raster command sets taken, PNG2POS_RASTER_BIT */
+  unsigned int buffer; /* receive buffer, bytes */
+  unsigned int speed; /* nominal print speed, mm/s */
+};
+
+/* bit of a raster command set in png2pos_profile.rasters */
+#define PNG2POS_RASTER_BIT(raster) (1u << (raster))
+
+/* number of built-in profiles; the first one is the default */
+unsigned int png2pos_profile_count(void);
+
+/* built-in profile i, NULL past the last one */
+const struct png2pos_profile *png2pos_profile_at(unsigned int i);
+
+/* built-in profile by name ("tm-t88", "tm-t20", "tm-j2100", "58mm"),
+   NULL for an unknown name */
+const struct png2pos_profile *png2pos_profile_find(const char *name);
+
+/* printer geometry, buffer and speed of a profile into opt; raster is
+   set to the first command set the profile takes unless it takes the one
+   already selected */
+void png2pos_profile_apply(const struct png2pos_profile *profile,
+                           struct png2pos_options *opt);
+
+#endif /* PNG2POS_PROFILE_H */
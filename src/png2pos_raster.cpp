@@ -0,0 +1,265 @@
+#include <string.h>
+#include "png2pos_raster.h"
+
+/* most rows one GS v 0 command may carry */
+#define GSV0_MAX_Y 2303u
+
+/* rows of one ESC * 24-dot bit image line */
+#define COLUMN_ROWS 24u
+
+/* columns transposed at a time in column mode */
+#define COLUMN_CHUNK 64u
+
+static const struct {
+  const char *name;
+  enum png2pos_raster raster;
+} names[] = {
+  { "gs8l", PNG2POS_RASTER_GS8L },
+  { "gsv0", PNG2POS_RASTER_GSV0 },
+  { "column", PNG2POS_RASTER_COLUMN }
+};
+
+int png2pos_raster_from_name(const char *name) {
+  for (unsigned int i = 0; i != sizeof names / sizeof names[0]; ++i) {
+    if (!strcmp(name, names[i].name)) {
+      return names[i].raster;
+    }
+  }
+  return -1;
+}
+
+const char *png2pos_raster_name(enum png2pos_raster raster) {
+  for (unsigned int i = 0; i != sizeof names / sizeof names[0]; ++i) {
+    if (names[i].raster == raster) {
+      return names[i].name;
+    }
+  }
+  return NULL;
+}
+
+unsigned int png2pos_raster_band_rows(enum png2pos_raster raster,
+                                      unsigned int canvas_w,
+                                      unsigned int gs8l_max_y,
+                                      unsigned int buffer) {
+  switch (raster) {
+  case PNG2POS_RASTER_GSV0: {
+    /* a band fits the receive buffer, so each one is printed while the
+       next is on its way */
+    unsigned int k = buffer / (canvas_w >> 3);
+    return k < 1 ? 1 : k > GSV0_MAX_Y ? GSV0_MAX_Y : k;
+  }
+
+  case PNG2POS_RASTER_COLUMN:
+    return COLUMN_ROWS;
+
+  case PNG2POS_RASTER_GS8L:
+  default:
+    return gs8l_max_y;
+  }
+}
+
+unsigned int png2pos_raster_block_cost(enum png2pos_raster raster) {
+  switch (raster) {
+  case PNG2POS_RASTER_GSV0:
+    return 8;
+
+  case PNG2POS_RASTER_COLUMN:
+    return 0;
+
+  case PNG2POS_RASTER_GS8L:
+  default:
+    return 17 + 7;
+  }
+}
+
+unsigned int png2pos_raster_can_zoom(enum png2pos_raster raster) {
+  return raster != PNG2POS_RASTER_COLUMN;
+}
+
+/* GS 8 L function 112 + GS ( L function 50 */
+static void s_gs8l(const unsigned char *bits, unsigned int canvas_w,
+                   unsigned int k, unsigned int by,
+                   struct png2pos_sink *sink) {
+  const unsigned int f112_p = 10 + k * (canvas_w >> 3);
+  unsigned char ESC_STORE[17];
+
+  ESC_STORE[ 0] = 0x1d; /* GS 8 L, Store the graphics data in the print buffer (raster format), p. 252 */
+  ESC_STORE[ 1] = 0x38;
+  ESC_STORE[ 2] = 0x4c;
+  ESC_STORE[ 3] = f112_p & 0xff; /* p1 p2 p3 p4 */
+  ESC_STORE[ 4] = f112_p >> 8 & 0xff;
+  ESC_STORE[ 5] = f112_p >> 16 & 0xff;
+  ESC_STORE[ 6] = f112_p >> 24 & 0xff;
+  ESC_STORE[ 7] = 0x30; /* Function 112 */
+  ESC_STORE[ 8] = 0x70;
+  ESC_STORE[ 9] = 0x30;
+  ESC_STORE[10] = 0x01; /* bx by, zoom */
+  ESC_STORE[11] = by;
+  ESC_STORE[12] = 0x31; /* c, single-color printing model */
+  ESC_STORE[13] = canvas_w & 0xff; /* xl, xh, number of dots in the horizontal direction */
+  ESC_STORE[14] = canvas_w >> 8 & 0xff;
+  ESC_STORE[15] = k & 0xff; /* yl, yh, number of dots in the vertical direction */
+  ESC_STORE[16] = k >> 8 & 0xff;
+
+  const unsigned char ESC_FLUSH[7] = {
+    /* GS ( L, Print the graphics data in the print buffer,
+     p. 241 Moves print position to the left side of the
+     print area after printing of graphics data is
+     completed */
+    0x1d, 0x28, 0x4c, 0x02, 0x00, 0x30,
+    /* Fn 50 */
+    0x32
+  };
+
+  const struct png2pos_iov iov[3] = {
+    { ESC_STORE, sizeof ESC_STORE },
+    { bits, k * (canvas_w >> 3) },
+    { ESC_FLUSH, sizeof ESC_FLUSH }
+  };
+  png2pos_sink_writev(sink, iov, 3);
+}
+
+/* GS v 0, printed as soon as it has been received */
+static void s_gsv0(const unsigned char *bits, unsigned int canvas_w,
+                   unsigned int k, unsigned int by,
+                   struct png2pos_sink *sink) {
+  const unsigned int row_bytes = canvas_w >> 3;
+  unsigned char ESC_RASTER[8];
+
+  ESC_RASTER[0] = 0x1d; /* GS v 0, Print raster bit image, p. 324 */
+  ESC_RASTER[1] = 0x76;
+  ESC_RASTER[2] = 0x30;
+  ESC_RASTER[3] = by == 2 ? 2 : 0; /* m, normal or double-height */
+  ESC_RASTER[4] = row_bytes & 0xff; /* xL xH, bytes in the horizontal direction */
+  ESC_RASTER[5] = row_bytes >> 8 & 0xff;
+  ESC_RASTER[6] = k & 0xff; /* yL yH, dots in the vertical direction */
+  ESC_RASTER[7] = k >> 8 & 0xff;
+
+  const struct png2pos_iov iov[2] = {
+    { ESC_RASTER, sizeof ESC_RASTER },
+    { bits, k * row_bytes }
+  };
+  png2pos_sink_writev(sink, iov, 2);
+}
+
+/* ESC * m = 33, one 24 dot high line; k <= 24 rows, the rest is white and
+   the paper moves on by the k rows only */
+static void s_column(const unsigned char *bits, unsigned int canvas_w,
+                     unsigned int k, struct png2pos_sink *sink) {
+  const unsigned int row_bytes = canvas_w >> 3;
+  unsigned char ESC_IMAGE[5];
+
+  ESC_IMAGE[0] = 0x1b; /* ESC *, Select bit-image mode, p. 120 */
+  ESC_IMAGE[1] = 0x2a;
+  ESC_IMAGE[2] = 33; /* m, 24-dot double-density */
+  ESC_IMAGE[3] = canvas_w & 0xff; /* nL nH, dots in the horizontal direction */
+  ESC_IMAGE[4] = canvas_w >> 8 & 0xff;
+
+  png2pos_sink_write(sink, ESC_IMAGE, sizeof ESC_IMAGE);
+
+  /* every column is 3 bytes, top dot in the most significant bit */
+  unsigned char cols[COLUMN_CHUNK * 3];
+
+  for (unsigned int x0 = 0; x0 < canvas_w; x0 += COLUMN_CHUNK) {
+    unsigned int n = canvas_w - x0 < COLUMN_CHUNK ? canvas_w - x0
+                                                  : COLUMN_CHUNK;
+
+    memset(cols, 0, n * 3);
+    for (unsigned int y = 0; y != k; ++y) {
+      const unsigned char *row = &bits[y * row_bytes];
+      unsigned char *dst = &cols[y >> 3];
+      unsigned char mask = 0x80 >> (y & 7);
+
+      for (unsigned int x = 0; x != n; ++x) {
+        if (row[(x0 + x) >> 3] & (0x80 >> ((x0 + x) & 7))) {
+          dst[x * 3] |= mask;
+        }
+      }
+    }
+    png2pos_sink_write(sink, cols, n * 3);
+  }
+
+  /* print the line and move to the next one */
+  png2pos_raster_feed(k, sink);
+}
+
+void png2pos_raster_block(enum png2pos_raster raster,
+                          const unsigned char *bits, unsigned int canvas_w,
+                          unsigned int k, unsigned int by,
+                          struct png2pos_sink *sink) {
+  switch (raster) {
+  case PNG2POS_RASTER_GSV0:
+    s_gsv0(bits, canvas_w, k, by, sink);
+    break;
+
+  case PNG2POS_RASTER_COLUMN:
+    s_column(bits, canvas_w, k, sink);
+    break;
+
+  case PNG2POS_RASTER_GS8L:
+  default:
+    s_gs8l(bits, canvas_w, k, by, sink);
+  }
+}
+
+void png2pos_raster_define(enum png2pos_store store,
+                           const unsigned char key[2],
+                           const unsigned char *bits, unsigned int canvas_w,
+                           unsigned int k, struct png2pos_sink *sink) {
+  const unsigned int p = 11 + k * (canvas_w >> 3);
+  unsigned char ESC_DEFINE[18];
+
+  ESC_DEFINE[ 0] = 0x1d; /* GS 8 L, Define the NV / download graphics data (raster format), p. 229 / 263 */
+  ESC_DEFINE[ 1] = 0x38;
+  ESC_DEFINE[ 2] = 0x4c;
+  ESC_DEFINE[ 3] = p & 0xff; /* p1 p2 p3 p4 */
+  ESC_DEFINE[ 4] = p >> 8 & 0xff;
+  ESC_DEFINE[ 5] = p >> 16 & 0xff;
+  ESC_DEFINE[ 6] = p >> 24 & 0xff;
+  ESC_DEFINE[ 7] = 0x30; /* Function 67 (NV) or 83 (download) */
+  ESC_DEFINE[ 8] = store == PNG2POS_STORE_DOWNLOAD ? 0x53 : 0x43;
+  ESC_DEFINE[ 9] = 0x30; /* a, raster format */
+  ESC_DEFINE[10] = key[0]; /* kc1 kc2, key code */
+  ESC_DEFINE[11] = key[1];
+  ESC_DEFINE[12] = 0x01; /* b, number of colors */
+  ESC_DEFINE[13] = canvas_w & 0xff; /* xL xH, number of dots in the horizontal direction */
+  ESC_DEFINE[14] = canvas_w >> 8 & 0xff;
+  ESC_DEFINE[15] = k & 0xff; /* yL yH, number of dots in the vertical direction */
+  ESC_DEFINE[16] = k >> 8 & 0xff;
+  ESC_DEFINE[17] = 0x31; /* c, color 1 */
+
+  const struct png2pos_iov iov[2] = {
+    { ESC_DEFINE, sizeof ESC_DEFINE },
+    { bits, k * (canvas_w >> 3) }
+  };
+  png2pos_sink_writev(sink, iov, 2);
+}
+
+void png2pos_raster_feed(unsigned int n, struct png2pos_sink *sink) {
+  while (n) {
+    unsigned int step = n > 255 ? 255 : n;
+    const unsigned char ESC_FEED[3] = {
+      /* ESC J, Print and feed paper, p. 97; n vertical motion units */
+      0x1b, 0x4a, (unsigned char)step
+    };
+
+    png2pos_sink_write(sink, ESC_FEED, sizeof ESC_FEED);
+    n -= step;
+  }
+}
+
+unsigned int png2pos_raster_motion(unsigned int dpi,
+                                   struct png2pos_sink *sink) {
+  if (dpi > 255) {
+    return 0;
+  }
+
+  const unsigned char ESC_MOTION[4] = {
+    /* GS P, Set horizontal and vertical motion units; x = 0 keeps the
+       default horizontal unit */
+    0x1d, 0x50, 0x00, (unsigned char)dpi
+  };
+
+  png2pos_sink_write(sink, ESC_MOTION, sizeof ESC_MOTION);
+  return 1;
+}
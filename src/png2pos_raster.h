@@ -0,0 +1,83 @@
+/* png2pos_raster.h, raster command sets the png2pos converter can emit
+
+   A band of packed rows (1 bit per dot, most significant bit first, rows
+   canvas_w / 8 bytes apart) is turned into the printer commands of one of
+   the backends below. Each backend has its own band height and its own
+   cost per block, which the converter uses to decide where to split. */
+
+#ifndef PNG2POS_RASTER_H
+#define PNG2POS_RASTER_H
+
+#include <stddef.h>
+#include "png2pos_sink.h"
+
+enum png2pos_raster {
+  /* GS 8 L function 112 + GS ( L function 50, stored then printed */
+  PNG2POS_RASTER_GS8L = 0,
+  /* GS v 0, printed as it arrives; small bands so printing starts early */
+  PNG2POS_RASTER_GSV0,
+  /* ESC * 24-dot double density bit image, one 24 row line at a time */
+  PNG2POS_RASTER_COLUMN
+};
+
+/* printer memory a graphic can be stored in and printed from by key code */
+enum png2pos_store {
+  PNG2POS_STORE_NONE = 0,
+  /* NV graphics, GS ( L functions 67 / 69, survives power off */
+  PNG2POS_STORE_NV,
+  /* download graphics, GS ( L functions 83 / 85, cleared at power off */
+  PNG2POS_STORE_DOWNLOAD
+};
+
+/* most rows of a stored graphic */
+#define PNG2POS_STORE_MAX_Y 2304u
+
+/* raster command set for a name as used from R ("gs8l", "gsv0",
+   "column"); returns -1 for an unknown name */
+int png2pos_raster_from_name(const char *name);
+
+/* name of a raster command set, NULL if there is none */
+const char *png2pos_raster_name(enum png2pos_raster raster);
+
+/* rows per band for a raster canvas_w dots wide; gs8l_max_y is the
+   printer's limit for GS 8 L, GS v 0 bands are kept within its receive
+   buffer of buffer bytes */
+unsigned int png2pos_raster_band_rows(enum png2pos_raster raster,
+                                      unsigned int canvas_w,
+                                      unsigned int gs8l_max_y,
+                                      unsigned int buffer);
+
+/* bytes of commands around the data of every block; 0 if a band cannot be
+   split into blocks of fewer rows (column mode) */
+unsigned int png2pos_raster_block_cost(enum png2pos_raster raster);
+
+/* whether blocks can be printed at double height (by = 2) */
+unsigned int png2pos_raster_can_zoom(enum png2pos_raster raster);
+
+/* print k rows of canvas_w dots, every row by dots high; a block is one
+   write to sink, its rows taken straight from bits */
+void png2pos_raster_block(enum png2pos_raster raster,
+                          const unsigned char *bits, unsigned int canvas_w,
+                          unsigned int k, unsigned int by,
+                          struct png2pos_sink *sink);
+
+/* define k rows of canvas_w dots as the stored graphic with key code
+   key[0] key[1] (each 32..126); k <= PNG2POS_STORE_MAX_Y */
+void png2pos_raster_define(enum png2pos_store store,
+                           const unsigned char key[2],
+                           const unsigned char *bits, unsigned int canvas_w,
+                           unsigned int k, struct png2pos_sink *sink);
+
+/* advance the paper by n motion units without printing; one dot row
+   once png2pos_raster_motion() has set the unit */
+void png2pos_raster_feed(unsigned int n, struct png2pos_sink *sink);
+
+/* set the vertical motion unit to 1 / dpi inch, one dot row, so that
+   feeds (and the line feed of column mode) move by dot rows whatever the
+   printer's default unit; dpi 0 restores the default, as ESC @ leaves it.
+   GS P takes at most 255: returns 0 without writing anything for a
+   higher dpi, which leaves the unit at the printer's default */
+unsigned int png2pos_raster_motion(unsigned int dpi,
+                                   struct png2pos_sink *sink);
+
+#endif /* PNG2POS_RASTER_H */
@@ -0,0 +1,145 @@
+#include <stdlib.h>
+#include "png2pos_arena.h"
+#include "png2pos_scale.h"
+
+/* input pixels covered by one output pixel along one side, in units of
+   1 / out of an input pixel: the first one by w0 units, n whole ones by
+   out units each, then the last one by w1 units (none if w1 is 0) */
+struct s_span {
+  unsigned int i0;
+  unsigned int n;
+  unsigned int w0;
+  unsigned int w1;
+};
+
+/* spans of the out pixels a side of len input pixels is cut into; an
+   output pixel is len units long, an input pixel out units */
+static void s_spans(struct s_span *spans, unsigned int len,
+                    unsigned int out) {
+  for (unsigned int c = 0; c != out; ++c) {
+    unsigned long long start = (unsigned long long)c * len;
+    unsigned int i0 = (unsigned int)(start / out);
+    unsigned int w0 = (unsigned int)((unsigned long long)(i0 + 1) * out
+                                     - start);
+
+    if (w0 > len) {
+      w0 = len;
+    }
+
+    spans[c].i0 = i0;
+    spans[c].w0 = w0;
+    spans[c].n = (len - w0) / out;
+    spans[c].w1 = (len - w0) % out;
+  }
+}
+
+/* one input row summed into the output columns, each weighted sum out of
+   at most 255 * img_w */
+static void s_sum_row(const unsigned char *row, const struct s_span *cols,
+                      unsigned int out_w, unsigned int *sums) {
+  for (unsigned int c = 0; c != out_w; ++c) {
+    const struct s_span *s = &cols[c];
+    const unsigned char *p = &row[s->i0];
+    unsigned int whole = 0;
+
+    /* the bulk of every span for large factors, a plain sum that
+       vectorises */
+    for (unsigned int j = 1; j <= s->n; ++j) {
+      whole += p[j];
+    }
+
+    unsigned int sum = s->w0 * p[0] + out_w * whole;
+    if (s->w1) {
+      sum += s->w1 * p[s->n + 1];
+    }
+    sums[c] = sum;
+  }
+}
+
+unsigned int png2pos_scale_height(unsigned int img_w, unsigned int img_h,
+                                  unsigned int out_w) {
+  if (!img_w) {
+    return img_h;
+  }
+
+  unsigned long long h = ((unsigned long long)img_h * out_w + img_w / 2)
+                         / img_w;
+  return h < 1 ? 1 : (unsigned int)h;
+}
+
+unsigned int png2pos_scale_grey(unsigned char *grey, unsigned int img_w,
+                                unsigned int img_h, unsigned int out_w,
+                                unsigned int out_h,
+                                unsigned int histogram[256]) {
+  if (!out_w || !out_h) {
+    return 0;
+  }
+
+  struct s_span *cols, *rows;
+  unsigned int *sums;
+  unsigned long long *acc;
+
+  cols = (struct s_span *)png2pos_arena_alloc(out_w * sizeof *cols);
+  rows = (struct s_span *)png2pos_arena_alloc(out_h * sizeof *rows);
+  sums = (unsigned int *)png2pos_arena_alloc(out_w * sizeof *sums);
+  acc = (unsigned long long *)png2pos_arena_alloc(out_w * sizeof *acc);
+
+  if (!cols || !rows || !sums || !acc) {
+    png2pos_arena_free(acc);
+    png2pos_arena_free(sums);
+    png2pos_arena_free(rows);
+    png2pos_arena_free(cols);
+    return 1;
+  }
+
+  s_spans(cols, img_w, out_w);
+  s_spans(rows, img_h, out_h);
+
+  /* every output pixel weighs img_w * img_h units in all */
+  const unsigned long long area = (unsigned long long)img_w * img_h;
+
+  /* the last input row of one output row is usually the first of the
+     next, its sums are kept rather than worked out twice */
+  unsigned int summed = img_h;
+
+  for (unsigned int y = 0; y != out_h; ++y) {
+    const struct s_span *s = &rows[y];
+    unsigned int last = s->i0 + s->n + (s->w1 ? 1 : 0);
+
+    for (unsigned int r = s->i0; r <= last; ++r) {
+      unsigned int w = r == s->i0 ? s->w0
+                     : r <= s->i0 + s->n ? out_h
+                     : s->w1;
+
+      if (r != summed) {
+        s_sum_row(&grey[(size_t)r * img_w], cols, out_w, sums);
+        summed = r;
+      }
+
+      if (r == s->i0) {
+        for (unsigned int c = 0; c != out_w; ++c) {
+          acc[c] = (unsigned long long)w * sums[c];
+        }
+      } else {
+        for (unsigned int c = 0; c != out_w; ++c) {
+          acc[c] += (unsigned long long)w * sums[c];
+        }
+      }
+    }
+
+    /* the input rows of later output rows start at or below row y + 1, so
+       output row y can be stored over the start of the plane */
+    unsigned char *out = &grey[(size_t)y * out_w];
+    for (unsigned int c = 0; c != out_w; ++c) {
+      out[c] = (unsigned char)((acc[c] + area / 2) / area);
+      ++histogram[out[c]];
+    }
+  }
+
+  png2pos_arena_free(acc);
+  png2pos_arena_free(sums);
+  png2pos_arena_free(rows);
+  png2pos_arena_free(cols);
+
+  return 0;
+}
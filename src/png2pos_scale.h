@@ -0,0 +1,24 @@
+/* png2pos_scale.h, grey plane downscaling for the png2pos converter
+
+   Area averaging: every output pixel is the mean of the input pixels it
+   covers, partly covered ones weighted by how much of them it covers. The
+   weights are exact integers, so the result does not depend on rounding
+   of the scale factor. */
+
+#ifndef PNG2POS_SCALE_H
+#define PNG2POS_SCALE_H
+
+/* height of an img_w x img_h image scaled to out_w wide, keeping its
+   aspect ratio; at least 1 */
+unsigned int png2pos_scale_height(unsigned int img_w, unsigned int img_h,
+                                  unsigned int out_w);
+
+/* scale the img_w x img_h grey plane down to out_w x out_h (out_w <= img_w,
+   out_h <= img_h) in place and count the new pixels into histogram[256];
+   returns 0 on success, non-zero if memory ran out */
+unsigned int png2pos_scale_grey(unsigned char *grey, unsigned int img_w,
+                                unsigned int img_h, unsigned int out_w,
+                                unsigned int out_h,
+                                unsigned int histogram[256]);
+
+#endif /* PNG2POS_SCALE_H */
@@ -0,0 +1,33 @@
+/* png2pos_simd.h, instruction set selection shared by the png2pos kernels
+
+   SSE2 is used whenever the compiler targets it (always on x86-64); AVX2
+   kernels are compiled with a target attribute and picked at run time, so
+   no extra compiler flags are needed. Everything else gets plain C. */
+
+#ifndef PNG2POS_SIMD_H
+#define PNG2POS_SIMD_H
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define PNG2POS_SSE2 1
+#endif
+
+#if defined(PNG2POS_SSE2) && (defined(__GNUC__) || defined(__clang__)) \
+  && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PNG2POS_AVX2 1
+#define PNG2POS_TARGET_AVX2 __attribute__((target("avx2")))
+
+static inline int png2pos_detect_avx2(void) {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") ? 1 : 0;
+}
+
+/* detected once, thread-safe (function local static) */
+static inline int png2pos_have_avx2(void) {
+  static const int have = png2pos_detect_avx2();
+  return have;
+}
+#endif
+
+#endif /* PNG2POS_SIMD_H */
@@ -0,0 +1,191 @@
+#include <string.h>
+#include "png2pos_sink.h"
+
+#include <errno.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <io.h>
+#else
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static void s_buffer_write(struct png2pos_sink *sink,
+                           const struct png2pos_iov *iov, unsigned int cnt) {
+  size_t total = 0;
+  for (unsigned int i = 0; i != cnt; ++i) {
+    total += iov[i].n;
+  }
+
+  /* one size check per call, then the pieces are copied in place */
+  std::vector<unsigned char> *out = sink->out;
+  size_t at = out->size();
+  out->resize(at + total);
+
+  for (unsigned int i = 0; i != cnt; ++i) {
+    if (iov[i].n) {
+      memcpy(&(*out)[at], iov[i].p, iov[i].n);
+      at += iov[i].n;
+    }
+  }
+}
+
+#ifdef _WIN32
+
+/* all of n pieces, one after the other */
+static unsigned int s_send(struct png2pos_sink *sink,
+                           struct png2pos_iov *v, unsigned int n) {
+  for (unsigned int i = 0; i != n; ++i) {
+    const unsigned char *p = v[i].p;
+    size_t left = v[i].n;
+
+    while (left) {
+      int chunk = left > 0x40000000u ? 0x40000000 : (int)left;
+      int done = sink->socket
+                 ? send((SOCKET)sink->fd, (const char *)p, chunk, 0)
+                 : _write((int)sink->fd, p, (unsigned int)chunk);
+      if (done < 0) {
+        unsigned int code = sink->socket ? (unsigned int)WSAGetLastError()
+                                         : (unsigned int)errno;
+        return code ? code : PNG2POS_SINK_FAILED;
+      }
+      if (!done) {
+        return PNG2POS_SINK_FAILED;
+      }
+      p += done;
+      left -= done;
+    }
+  }
+  return 0;
+}
+
+#else
+
+/* all of n pieces in as few system calls as the kernel allows; v is
+   advanced past what went out */
+static unsigned int s_send(struct png2pos_sink *sink,
+                           struct png2pos_iov *v, unsigned int n) {
+  struct iovec io[PNG2POS_SINK_MAX_IOV + 1];
+
+  while (n && !v->n) {
+    ++v;
+    --n;
+  }
+
+  while (n) {
+    for (unsigned int i = 0; i != n; ++i) {
+      io[i].iov_base = (void *)v[i].p;
+      io[i].iov_len = v[i].n;
+    }
+
+    ssize_t done;
+    if (sink->socket) {
+      struct msghdr msg;
+      memset(&msg, 0, sizeof msg);
+      msg.msg_iov = io;
+      msg.msg_iovlen = n;
+      done = sendmsg((int)sink->fd, &msg, MSG_NOSIGNAL);
+    } else {
+      done = writev((int)sink->fd, io, (int)n);
+    }
+
+    if (done < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return errno ? errno : PNG2POS_SINK_FAILED;
+    }
+
+    /* skip the pieces that went out, the rest of a partly sent one goes
+       with the next call */
+    size_t left = (size_t)done;
+    while (n && left >= v->n) {
+      left -= v->n;
+      ++v;
+      --n;
+    }
+    if (n) {
+      v->p += left;
+      v->n -= left;
+    }
+  }
+  return 0;
+}
+
+#endif
+
+static void s_stream_write(struct png2pos_sink *sink,
+                           const struct png2pos_iov *iov, unsigned int cnt) {
+  if (sink->error) {
+    return;
+  }
+
+  size_t total = 0;
+  for (unsigned int i = 0; i != cnt; ++i) {
+    total += iov[i].n;
+  }
+
+  /* commands and short rows wait for the next large write */
+  if (sink->staged + total <= PNG2POS_SINK_STAGE) {
+    for (unsigned int i = 0; i != cnt; ++i) {
+      memcpy(&sink->stage[sink->staged], iov[i].p, iov[i].n);
+      sink->staged += iov[i].n;
+    }
+    return;
+  }
+
+  /* the staged bytes and all pieces in one go, the pieces not copied */
+  struct png2pos_iov v[PNG2POS_SINK_MAX_IOV + 1];
+  v[0].p = sink->stage;
+  v[0].n = sink->staged;
+  memcpy(&v[1], iov, cnt * sizeof *iov);
+
+  sink->error = s_send(sink, v, cnt + 1);
+  sink->staged = 0;
+}
+
+void png2pos_sink_buffer(struct png2pos_sink *sink,
+                         std::vector<unsigned char> *out) {
+  sink->write = s_buffer_write;
+  sink->out = out;
+  sink->fd = -1;
+  sink->socket = 0;
+  sink->error = 0;
+  sink->staged = 0;
+}
+
+void png2pos_sink_fd(struct png2pos_sink *sink, int fd) {
+  sink->write = s_stream_write;
+  sink->out = NULL;
+  sink->fd = fd;
+  sink->socket = 0;
+  sink->error = 0;
+  sink->staged = 0;
+}
+
+void png2pos_sink_socket(struct png2pos_sink *sink, intptr_t s) {
+  png2pos_sink_fd(sink, -1);
+  sink->fd = s;
+  sink->socket = 1;
+
+#if defined(SO_NOSIGPIPE)
+  /* no MSG_NOSIGNAL on macOS, the socket is told instead */
+  int on = 1;
+  setsockopt((int)s, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof on);
+#endif
+}
+
+unsigned int png2pos_sink_flush(struct png2pos_sink *sink) {
+  if (sink->staged && !sink->error) {
+    struct png2pos_iov v = { sink->stage, sink->staged };
+    sink->error = s_send(sink, &v, 1);
+  }
+  sink->staged = 0;
+  return sink->error;
+}
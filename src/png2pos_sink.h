@@ -0,0 +1,76 @@
+/* png2pos_sink.h, where the png2pos converter's ESC/POS stream goes
+
+   Writers hand a sink the pieces of one command at a time (header, bitmap
+   rows, trailer) as an array of pointers into their own buffers, like
+   writev(2). A buffer sink appends them to a growable buffer; descriptor
+   and socket sinks gather small commands in a staging area and send it
+   together with the next large piece in a single system call, so the
+   bitmap rows go to the kernel straight from the converter's band. */
+
+#ifndef PNG2POS_SINK_H
+#define PNG2POS_SINK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/* most pieces a writer hands over at once */
+#define PNG2POS_SINK_MAX_IOV 8u
+
+/* bytes of small writes a descriptor or socket sink gathers */
+#define PNG2POS_SINK_STAGE 4096u
+
+/* error of a write that failed without an error code */
+#define PNG2POS_SINK_FAILED 0xffffffffu
+
+/* one piece of a write */
+struct png2pos_iov {
+  const unsigned char *p;
+  size_t n;
+};
+
+struct png2pos_sink {
+  /* takes cnt <= PNG2POS_SINK_MAX_IOV pieces, in order; they only have to
+     stay valid for the call */
+  void (*write)(struct png2pos_sink *sink, const struct png2pos_iov *iov,
+                unsigned int cnt);
+  std::vector<unsigned char> *out; /* buffer sinks */
+  intptr_t fd; /* descriptor or socket sinks */
+  unsigned int socket; /* fd is a socket */
+  unsigned int error; /* errno (WSAGetLastError() for sockets on Windows)
+                         of the first failed write, PNG2POS_SINK_FAILED
+                         if there was none; later writes are dropped */
+  size_t staged; /* bytes waiting in stage */
+  unsigned char stage[PNG2POS_SINK_STAGE];
+};
+
+/* sink appending to out, which grows as needed */
+void png2pos_sink_buffer(struct png2pos_sink *sink,
+                         std::vector<unsigned char> *out);
+
+/* sink writing to the open file descriptor fd */
+void png2pos_sink_fd(struct png2pos_sink *sink, int fd);
+
+/* sink sending on the connected stream socket s (a SOCKET on Windows);
+   a peer closing the connection is an error, not a signal */
+void png2pos_sink_socket(struct png2pos_sink *sink, intptr_t s);
+
+/* send whatever is still staged; returns the sink's error, 0 if all of
+   the stream was written */
+unsigned int png2pos_sink_flush(struct png2pos_sink *sink);
+
+/* write cnt pieces */
+static inline void png2pos_sink_writev(struct png2pos_sink *sink,
+                                       const struct png2pos_iov *iov,
+                                       unsigned int cnt) {
+  sink->write(sink, iov, cnt);
+}
+
+/* write the n bytes at p */
+static inline void png2pos_sink_write(struct png2pos_sink *sink,
+                                      const unsigned char *p, size_t n) {
+  struct png2pos_iov iov = { p, n };
+  sink->write(sink, &iov, 1);
+}
+
+#endif /* PNG2POS_SINK_H */
@@ -0,0 +1,346 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "png2pos_arena.h"
+#include "png2pos_tone.h"
+
+/* CLAHE tiles in either direction, fewer for images too small to give each
+   tile CLAHE_MIN_TILE pixels */
+#ifndef CLAHE_TILES
+#define CLAHE_TILES 8u
+#endif
+#define CLAHE_MIN_TILE 16u
+
+int png2pos_equalise_from_name(const char *name) {
+  static const struct {
+    const char *name;
+    enum png2pos_equalise equalise;
+  } names[] = {
+    { "none", PNG2POS_EQUALISE_NONE },
+    { "global", PNG2POS_EQUALISE_GLOBAL },
+    { "clahe", PNG2POS_EQUALISE_CLAHE }
+  };
+
+  for (unsigned int i = 0; i != sizeof names / sizeof names[0]; ++i) {
+    if (!strcmp(name, names[i].name)) {
+      return names[i].equalise;
+    }
+  }
+  return -1;
+}
+
+/* the curve applied after equalisation: gamma, then contrast, then
+   brightness; the neutral settings give exactly the identity */
+static void s_curve(const struct png2pos_tone_curve *curve,
+                    unsigned char out[256]) {
+  for (unsigned int v = 0; v != 256; ++v) {
+    double x = v;
+
+    if (curve->gamma > 0 && curve->gamma != 1) {
+      x = 255.0 * pow(x / 255.0, 1.0 / curve->gamma);
+    }
+    if (curve->contrast != 1) {
+      x = (x - 128.0) * curve->contrast + 128.0;
+    }
+    x += curve->brightness;
+
+    long r = lround(x);
+    out[v] = r < 0 ? 0 : r > 255 ? 255 : (unsigned char)r;
+  }
+}
+
+/* equalised level of v for a cumulative histogram over n pixels */
+static inline unsigned char s_equalised(const unsigned int *cumulative,
+                                        unsigned int v, size_t n) {
+  return (unsigned char)(255 * (unsigned long long)cumulative[v] / n);
+}
+
+/* bounds of tile i of n along a side of len pixels */
+static inline unsigned int s_tile_edge(unsigned int i, unsigned int n,
+                                       unsigned int len) {
+  return (unsigned int)((unsigned long long)i * len / n);
+}
+
+/* contrast-limited equalisation table of tile t, composed with the curve */
+static void s_clahe_tile(struct png2pos_tone *tone,
+                         const struct png2pos_tone_curve *curve,
+                         const unsigned char *img_grey, unsigned int t) {
+  unsigned int tx = t % tone->tiles_x;
+  unsigned int ty = t / tone->tiles_x;
+  unsigned int x0 = s_tile_edge(tx, tone->tiles_x, tone->img_w);
+  unsigned int x1 = s_tile_edge(tx + 1, tone->tiles_x, tone->img_w);
+  unsigned int y0 = s_tile_edge(ty, tone->tiles_y, tone->img_h);
+  unsigned int y1 = s_tile_edge(ty + 1, tone->tiles_y, tone->img_h);
+  size_t n = (size_t)(x1 - x0) * (y1 - y0);
+
+  unsigned int histogram[256] = { 0 };
+
+  for (unsigned int y = y0; y != y1; ++y) {
+    const unsigned char *row = &img_grey[(size_t)y * tone->img_w];
+    for (unsigned int x = x0; x != x1; ++x) {
+      ++histogram[row[x]];
+    }
+  }
+
+  /* clip every bin at the limit and hand the excess out evenly, which
+     bounds the slope of the mapping and so the noise it amplifies */
+  unsigned int limit = (unsigned int)(curve->clip_limit * n / 256);
+  if (limit < 1) {
+    limit = 1;
+  }
+
+  size_t excess = 0;
+  for (unsigned int v = 0; v != 256; ++v) {
+    if (histogram[v] > limit) {
+      excess += histogram[v] - limit;
+      histogram[v] = limit;
+    }
+  }
+  for (unsigned int v = 0; v != 256; ++v) {
+    histogram[v] += (unsigned int)(excess / 256 + (v < excess % 256));
+  }
+
+  for (unsigned int v = 1; v != 256; ++v) {
+    histogram[v] += histogram[v - 1];
+  }
+
+  unsigned char *lut = &tone->tile_lut[(size_t)t * 256];
+  for (unsigned int v = 0; v != 256; ++v) {
+    lut[v] = tone->lut[s_equalised(histogram, v, n)];
+  }
+}
+
+static void s_clahe_tiles(struct png2pos_tone *tone,
+                          const struct png2pos_tone_curve *curve,
+                          const unsigned char *img_grey, unsigned int first,
+                          unsigned int step) {
+  for (unsigned int t = first; t < tone->tiles_x * tone->tiles_y; t += step) {
+    s_clahe_tile(tone, curve, img_grey, t);
+  }
+}
+
+/* left (or upper) tile and weight of the next one, in 1/256, for pixel i
+   of a side of len pixels cut into n tiles; tiles are anchored at their
+   centres */
+static inline unsigned int s_tile_blend(unsigned int i, unsigned int n,
+                                        unsigned int len) {
+  double f = (i + 0.5) * n / len - 0.5;
+
+  if (f <= 0) {
+    return 0;
+  }
+
+  unsigned int t = (unsigned int)f;
+  if (t >= n - 1) {
+    return (n - 1) << 16;
+  }
+  return t << 16 | (unsigned int)((f - t) * 256);
+}
+
+unsigned int png2pos_tone_init(struct png2pos_tone *tone,
+                               const struct png2pos_tone_curve *curve,
+                               const unsigned char *img_grey,
+                               unsigned int img_w, unsigned int img_h,
+                               const unsigned int histogram[256],
+                               unsigned int threads) {
+  size_t n = (size_t)img_w * img_h;
+
+  tone->tiles_x = 0;
+  tone->tiles_y = 0;
+  tone->tile_lut = NULL;
+  tone->col = NULL;
+  tone->img_w = img_w;
+  tone->img_h = img_h;
+
+  s_curve(curve, tone->lut);
+
+  if (curve->equalise == PNG2POS_EQUALISE_GLOBAL && n) {
+    unsigned int cumulative[256];
+    unsigned char curved[256];
+
+    cumulative[0] = histogram[0];
+    for (unsigned int v = 1; v != 256; ++v) {
+      cumulative[v] = cumulative[v - 1] + histogram[v];
+    }
+
+    memcpy(curved, tone->lut, sizeof curved);
+    for (unsigned int v = 0; v != 256; ++v) {
+      tone->lut[v] = curved[s_equalised(cumulative, v, n)];
+    }
+  }
+
+  tone->identity = 1;
+  for (unsigned int v = 0; v != 256; ++v) {
+    if (tone->lut[v] != v) {
+      tone->identity = 0;
+    }
+  }
+
+  if (curve->equalise != PNG2POS_EQUALISE_CLAHE || !n) {
+    return 0;
+  }
+
+  tone->identity = 0;
+  tone->tiles_x = img_w / CLAHE_MIN_TILE;
+  tone->tiles_y = img_h / CLAHE_MIN_TILE;
+  if (tone->tiles_x > CLAHE_TILES) {
+    tone->tiles_x = CLAHE_TILES;
+  }
+  if (tone->tiles_y > CLAHE_TILES) {
+    tone->tiles_y = CLAHE_TILES;
+  }
+  if (tone->tiles_x < 1) {
+    tone->tiles_x = 1;
+  }
+  if (tone->tiles_y < 1) {
+    tone->tiles_y = 1;
+  }
+
+  unsigned int tiles = tone->tiles_x * tone->tiles_y;
+
+  tone->tile_lut = (unsigned char *)png2pos_arena_alloc((size_t)tiles * 256);
+  tone->col = (unsigned int *)png2pos_arena_alloc(img_w * sizeof *tone->col);
+  if (!tone->tile_lut || !tone->col) {
+    png2pos_tone_free(tone);
+    return 1;
+  }
+
+  for (unsigned int x = 0; x != img_w; ++x) {
+    tone->col[x] = s_tile_blend(x, tone->tiles_x, img_w);
+  }
+
+  /* tiles are independent, every thread takes every threads-th one */
+  if (threads > tiles) {
+    threads = tiles;
+  }
+  if (threads < 2 || n < 65536) {
+    s_clahe_tiles(tone, curve, img_grey, 0, 1);
+    return 0;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  try {
+    for (unsigned int t = 1; t < threads; ++t) {
+      workers.push_back(std::thread(s_clahe_tiles, tone, curve, img_grey, t,
+                                    threads));
+    }
+  } catch (const std::system_error &) {
+  }
+  s_clahe_tiles(tone, curve, img_grey, 0, threads);
+  /* the tiles of threads that could not be started */
+  for (unsigned int t = workers.size() + 1; t < threads; ++t) {
+    s_clahe_tiles(tone, curve, img_grey, t, threads);
+  }
+  for (unsigned int t = 0; t != workers.size(); ++t) {
+    workers[t].join();
+  }
+
+  return 0;
+}
+
+static void s_lut_rows(const struct png2pos_tone *tone,
+                       unsigned char *img_grey, unsigned int y_from,
+                       unsigned int y_to) {
+  const unsigned char *lut = tone->lut;
+  unsigned char *p = &img_grey[(size_t)y_from * tone->img_w];
+  size_t n = (size_t)(y_to - y_from) * tone->img_w;
+  size_t i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    unsigned char a = lut[p[i]];
+    unsigned char b = lut[p[i + 1]];
+    unsigned char c = lut[p[i + 2]];
+    unsigned char d = lut[p[i + 3]];
+    p[i] = a;
+    p[i + 1] = b;
+    p[i + 2] = c;
+    p[i + 3] = d;
+  }
+  for (; i != n; ++i) {
+    p[i] = lut[p[i]];
+  }
+}
+
+/* bilinear blend of the tables of the four tiles around every pixel */
+static void s_clahe_rows(const struct png2pos_tone *tone,
+                         unsigned char *img_grey, unsigned int y_from,
+                         unsigned int y_to) {
+  const size_t tile_row = (size_t)tone->tiles_x * 256;
+
+  for (unsigned int y = y_from; y != y_to; ++y) {
+    unsigned int b = s_tile_blend(y, tone->tiles_y, tone->img_h);
+    unsigned int ty = b >> 16;
+    unsigned int wy = b & 0xffff;
+    const unsigned char *top = &tone->tile_lut[ty * tile_row];
+    const unsigned char *bottom = wy ? top + tile_row : top;
+    unsigned char *row = &img_grey[(size_t)y * tone->img_w];
+
+    for (unsigned int x = 0; x != tone->img_w; ++x) {
+      unsigned int c = tone->col[x];
+      unsigned int wx = c & 0xffff;
+      unsigned int left = (c >> 16) * 256 + row[x];
+      unsigned int right = wx ? left + 256 : left;
+
+      unsigned int t = top[left] * (256 - wx) + top[right] * wx;
+      unsigned int u = bottom[left] * (256 - wx) + bottom[right] * wx;
+
+      row[x] = (unsigned char)((t * (256 - wy) + u * wy + 32768) >> 16);
+    }
+  }
+}
+
+static void s_tone_rows(const struct png2pos_tone *tone,
+                        unsigned char *img_grey, unsigned int y_from,
+                        unsigned int y_to) {
+  if (tone->tile_lut) {
+    s_clahe_rows(tone, img_grey, y_from, y_to);
+  } else {
+    s_lut_rows(tone, img_grey, y_from, y_to);
+  }
+}
+
+void png2pos_tone_rows(const struct png2pos_tone *tone,
+                       unsigned char *img_grey, unsigned int y_from,
+                       unsigned int y_to, unsigned int threads) {
+  unsigned int n = y_to - y_from;
+
+  if (tone->identity || !n) {
+    return;
+  }
+
+  if (threads < 2 || (size_t) n * tone->img_w < 65536) {
+    s_tone_rows(tone, img_grey, y_from, y_to);
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  try {
+    for (unsigned int t = 1; t < threads; ++t) {
+      workers.push_back(std::thread(s_tone_rows, tone, img_grey,
+                                    y_from + n * t / threads,
+                                    y_from + n * (t + 1) / threads));
+    }
+  } catch (const std::system_error &) {
+  }
+  s_tone_rows(tone, img_grey, y_from, y_from + n / threads);
+  /* the slices of threads that could not be started */
+  for (unsigned int t = workers.size() + 1; t < threads; ++t) {
+    s_tone_rows(tone, img_grey, y_from + n * t / threads,
+                y_from + n * (t + 1) / threads);
+  }
+  for (unsigned int t = 0; t != workers.size(); ++t) {
+    workers[t].join();
+  }
+}
+
+void png2pos_tone_free(struct png2pos_tone *tone) {
+  png2pos_arena_free(tone->col);
+  tone->col = NULL;
+  png2pos_arena_free(tone->tile_lut);
+  tone->tile_lut = NULL;
+}
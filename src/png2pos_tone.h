@@ -0,0 +1,60 @@
+/* png2pos_tone.h, tone mapping of the grey plane before dithering
+
+   Gamma, contrast, brightness and global histogram equalisation are folded
+   into one 256 entry table, so however many of them are in use each pixel
+   is looked up once. Contrast-limited adaptive equalisation (CLAHE) keeps
+   one table per tile instead, blended between the four nearest tiles. */
+
+#ifndef PNG2POS_TONE_H
+#define PNG2POS_TONE_H
+
+#include <stddef.h>
+
+enum png2pos_equalise {
+  PNG2POS_EQUALISE_NONE = 0,
+  PNG2POS_EQUALISE_GLOBAL, /* one histogram for the whole image */
+  PNG2POS_EQUALISE_CLAHE /* contrast-limited, per tile */
+};
+
+/* tone curve, everything the tables are built from */
+struct png2pos_tone_curve {
+  enum png2pos_equalise equalise;
+  float gamma; /* > 1 lightens the mid-tones */
+  float contrast; /* slope around mid grey, 1 = unchanged */
+  int brightness; /* added to every level */
+  float clip_limit; /* CLAHE, bin limit as a multiple of the mean bin */
+};
+
+struct png2pos_tone {
+  unsigned char lut[256]; /* global table, or the curve after CLAHE */
+  unsigned int identity; /* lut changes nothing and there is no CLAHE */
+  unsigned int tiles_x;
+  unsigned int tiles_y;
+  unsigned char *tile_lut; /* CLAHE, 256 entries per tile, row by row */
+  unsigned int *col; /* CLAHE, per column: left tile << 16 | weight */
+  unsigned int img_w;
+  unsigned int img_h;
+};
+
+/* equalisation method for a name as used from R ("none", "global",
+   "clahe"); returns -1 for an unknown name */
+int png2pos_equalise_from_name(const char *name);
+
+/* build the tables for an img_w x img_h grey plane with the given
+   histogram; CLAHE tiles are computed on up to threads threads; returns 0
+   on success, non-zero if memory ran out */
+unsigned int png2pos_tone_init(struct png2pos_tone *tone,
+                               const struct png2pos_tone_curve *curve,
+                               const unsigned char *img_grey,
+                               unsigned int img_w, unsigned int img_h,
+                               const unsigned int histogram[256],
+                               unsigned int threads);
+
+/* map rows [y_from; y_to) of img_grey in place */
+void png2pos_tone_rows(const struct png2pos_tone *tone,
+                       unsigned char *img_grey, unsigned int y_from,
+                       unsigned int y_to, unsigned int threads);
+
+void png2pos_tone_free(struct png2pos_tone *tone);
+
+#endif /* PNG2POS_TONE_H */